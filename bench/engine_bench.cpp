@@ -0,0 +1,280 @@
+/**
+ * engine-bench - cost of the canonical fixtures on each evaluation engine
+ *
+ * Runs the FIXTURE_GUIDE.md examples in bench/fixtures (door lock delay,
+ * cross-signal effect, lowpass filter, debounce) through every engine: the
+ * Lua DAG (<name>.yaml), the native interpreter (<name>_native.yaml) and the
+ * program fixture-codegen compiled from <name>_native.yaml, which the build
+ * links into this binary. One evaluation is one command followed by one pass,
+ * as the runner does for an actuation. Prints one line per fixture and engine:
+ *
+ *   fixture  engine  ns_per_eval  allocs_per_eval  p50_ns  p90_ns  p99_ns  max_ns
+ *
+ * Times are wall-clock nanoseconds per evaluation, including one clock read.
+ * Allocations count malloc, calloc and realloc calls, so Lua's allocator is
+ * included (glibc only; -1 elsewhere). --json PATH also writes the results,
+ * for tracking them across versions.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <glog/logging.h>
+#include <nlohmann/json.hpp>
+#include <vssdag/signal_processor.h>
+#include "fixture_config.hpp"
+#include "native_graph.hpp"
+
+#ifndef ENGINE_BENCH_FIXTURES
+#define ENGINE_BENCH_FIXTURES "fixtures"
+#endif
+
+namespace {
+
+std::atomic<uint64_t> g_allocations{0};
+
+}  // namespace
+
+#if defined(__GLIBC__)
+// Counting wrappers around the C allocator; operator new goes through malloc
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+
+void* malloc(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+}
+constexpr bool kCountsAllocations = true;
+#else
+constexpr bool kCountsAllocations = false;
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// The guide's examples and the type of the command each one is driven with
+struct Canonical {
+    const char* name;
+    vss::types::ValueType command;
+};
+
+constexpr Canonical kFixtures[] = {
+    {"door_lock", vss::types::ValueType::BOOL},
+    {"cross_signal", vss::types::ValueType::INT8},
+    {"lowpass", vss::types::ValueType::FLOAT},
+    {"debounce", vss::types::ValueType::BOOL},
+};
+
+// Command of evaluation |i|: booleans hold for 8 evaluations, numbers sweep 0..99
+double CommandValue(vss::types::ValueType type, uint64_t i) {
+    if (type == vss::types::ValueType::BOOL) {
+        return static_cast<double>((i / 8) % 2);
+    }
+    return static_cast<double>((i * 37) % 100);
+}
+
+struct Result {
+    std::string fixture;
+    std::string engine;
+    double ns_per_eval = 0;
+    double allocs_per_eval = -1;
+    int64_t p50_ns = 0;
+    int64_t p90_ns = 0;
+    int64_t p99_ns = 0;
+    int64_t max_ns = 0;
+};
+
+// Time |evals| calls of |eval|(i, now) after a short warm-up
+template <typename Eval>
+Result Measure(uint64_t evals, Eval eval) {
+    for (uint64_t i = 0; i < std::min<uint64_t>(evals / 10, 1000); ++i) {
+        eval(i, Clock::now());
+    }
+
+    std::vector<int64_t> latencies(evals);
+    const uint64_t allocations = g_allocations.load(std::memory_order_relaxed);
+    int64_t total = 0;
+    for (uint64_t i = 0; i < evals; ++i) {
+        const auto start = Clock::now();
+        eval(i, start);
+        latencies[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        total += latencies[i];
+    }
+
+    Result result;
+    result.ns_per_eval = static_cast<double>(total) / static_cast<double>(evals);
+    if (kCountsAllocations) {
+        result.allocs_per_eval = static_cast<double>(g_allocations.load(std::memory_order_relaxed) - allocations) /
+                                 static_cast<double>(evals);
+    }
+    auto percentile = [&](double p) {
+        auto it = latencies.begin() + static_cast<ptrdiff_t>(p * static_cast<double>(evals - 1));
+        std::nth_element(latencies.begin(), it, latencies.end());
+        return *it;
+    };
+    result.p50_ns = percentile(0.50);
+    result.p90_ns = percentile(0.90);
+    result.p99_ns = percentile(0.99);
+    result.max_ns = *std::max_element(latencies.begin(), latencies.end());
+    return result;
+}
+
+bool LoadSinglePart(const std::string& path, FixtureConfig& config) {
+    FixtureConfig loaded;
+    if (!LoadFixtureConfig(path, loaded)) {
+        return false;
+    }
+    auto parts = PartitionFixtureConfig(loaded);
+    if (parts.size() != 1) {
+        std::cerr << path << " has " << parts.size() << " independent parts; benchmark fixtures need one\n";
+        return false;
+    }
+    config = std::move(parts.front());
+    return true;
+}
+
+bool BenchLua(const Canonical& fixture, const FixtureConfig& config, uint64_t evals, Result& result) {
+    vssdag::SignalProcessorDAG dag;
+    if (!dag.initialize(BuildDagMappings(config))) {
+        std::cerr << fixture.name << ": failed to initialize the DAG\n";
+        return false;
+    }
+    const std::string target = config.serves.front() + ".target";
+    std::vector<vssdag::SignalUpdate> updates(1);
+    result = Measure(evals, [&](uint64_t i, Clock::time_point now) {
+        updates[0] = vssdag::SignalUpdate{target, VssValueFromNative(CommandValue(fixture.command, i), fixture.command),
+                                          now, vss::types::SignalQuality::VALID};
+        auto outputs = dag.process_signal_updates(updates);
+        (void)outputs;
+    });
+    return true;
+}
+
+Result BenchNative(const Canonical& fixture, NativeProgram& program, uint64_t evals) {
+    std::vector<NativeOutput> outputs;
+    outputs.reserve(16);
+    return Measure(evals, [&](uint64_t i, Clock::time_point now) {
+        program.set_input(0, CommandValue(fixture.command, i));
+        outputs.clear();
+        program.evaluate(now, outputs);
+    });
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    google::InitGoogleLogging(argv[0]);
+    FLAGS_logtostderr = 1;
+    FLAGS_minloglevel = google::WARNING;
+
+    std::string fixtures_dir = ENGINE_BENCH_FIXTURES;
+    std::string json_file;
+    uint64_t evals = 200000;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--fixtures" && i + 1 < argc) {
+            fixtures_dir = argv[++i];
+        } else if (arg == "--evals" && i + 1 < argc) {
+            evals = std::max<uint64_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--json" && i + 1 < argc) {
+            json_file = argv[++i];
+        }
+    }
+
+    std::vector<Result> results;
+    for (const auto& fixture : kFixtures) {
+        const std::string base = fixtures_dir + "/" + fixture.name;
+
+        FixtureConfig lua;
+        if (!LoadSinglePart(base + ".yaml", lua)) {
+            return 1;
+        }
+        Result result;
+        if (!BenchLua(fixture, lua, evals, result)) {
+            return 1;
+        }
+        result.fixture = fixture.name;
+        result.engine = "lua";
+        results.push_back(result);
+
+        FixtureConfig native;
+        NativeGraphSpec spec;
+        if (!LoadSinglePart(base + "_native.yaml", native)) {
+            return 1;
+        }
+        if (auto error = BuildNativeGraphSpec(native.native_mappings, native.serves, spec)) {
+            std::cerr << fixture.name << ": " << *error << "\n";
+            return 1;
+        }
+        NativeGraph interpreter(spec);
+        result = BenchNative(fixture, interpreter, evals);
+        result.fixture = fixture.name;
+        result.engine = "native";
+        results.push_back(result);
+
+        if (const auto* compiled = CompiledNativeProgram::find(spec.fingerprint())) {
+            auto program = compiled->create(native.seed);
+            result = BenchNative(fixture, *program, evals);
+            result.fixture = fixture.name;
+            result.engine = "codegen";
+            results.push_back(result);
+        } else {
+            std::cerr << fixture.name << ": no compiled program linked in, codegen skipped\n";
+        }
+    }
+
+    std::cout << std::left << std::setw(14) << "fixture" << std::setw(9) << "engine" << std::right
+              << std::setw(13) << "ns_per_eval" << std::setw(17) << "allocs_per_eval" << std::setw(10) << "p50_ns"
+              << std::setw(10) << "p90_ns" << std::setw(10) << "p99_ns" << std::setw(10) << "max_ns" << "\n";
+    std::cout << std::fixed;
+    for (const auto& result : results) {
+        std::cout << std::left << std::setw(14) << result.fixture << std::setw(9) << result.engine << std::right
+                  << std::setprecision(1) << std::setw(13) << result.ns_per_eval << std::setprecision(2)
+                  << std::setw(17) << result.allocs_per_eval << std::setw(10) << result.p50_ns << std::setw(10)
+                  << result.p90_ns << std::setw(10) << result.p99_ns << std::setw(10) << result.max_ns << "\n";
+    }
+
+    if (!json_file.empty()) {
+        nlohmann::json j;
+        j["evals"] = evals;
+        j["results"] = nlohmann::json::array();
+        for (const auto& result : results) {
+            nlohmann::json entry = {
+                {"fixture", result.fixture},
+                {"engine", result.engine},
+                {"ns_per_eval", result.ns_per_eval},
+                {"latency_ns", {{"p50", result.p50_ns}, {"p90", result.p90_ns}, {"p99", result.p99_ns},
+                                {"max", result.max_ns}}},
+            };
+            entry["allocs_per_eval"] = kCountsAllocations ? nlohmann::json(result.allocs_per_eval) : nlohmann::json();
+            j["results"].push_back(std::move(entry));
+        }
+        std::ofstream out(json_file, std::ios::trunc);
+        out << j.dump(2) << "\n";
+        if (!out) {
+            std::cerr << "Cannot write " << json_file << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
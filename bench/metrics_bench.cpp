@@ -0,0 +1,114 @@
+/**
+ * metrics-bench - cost of recording metrics from concurrent threads
+ *
+ * Each thread records events as fast as it can into one shared metric, for
+ * each thread count. A single shared atomic, as counters were before they
+ * were sharded, is measured alongside for comparison. Prints one line per
+ * thread count:
+ *
+ *   threads  atomic_ns  counter_ns  histogram_ns  cpu_at_1M_%
+ *
+ * Times are CPU nanoseconds per event, averaged over the threads, so they
+ * stay comparable when there are more threads than cores. cpu_at_1M_% is the
+ * share of one core that counter plus histogram recording takes at one
+ * million events per second in total.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <time.h>
+#include "metrics.hpp"
+
+namespace {
+
+double ThreadCpuNanos() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) * 1e9 + static_cast<double>(ts.tv_nsec);
+}
+
+// CPU nanoseconds per event when |threads| threads each call |record| |events| times
+template <typename Record>
+double Measure(size_t threads, uint64_t events, Record record) {
+    std::atomic<size_t> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    std::vector<double> nanos(threads);
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            ready.fetch_add(1);
+            while (!go.load()) {
+            }
+            const double start = ThreadCpuNanos();
+            for (uint64_t i = 0; i < events; ++i) {
+                record(i);
+            }
+            nanos[t] = ThreadCpuNanos() - start;
+        });
+    }
+    while (ready.load() < threads) {
+    }
+    go = true;
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double total = 0.0;
+    for (double n : nanos) {
+        total += n;
+    }
+    return total / static_cast<double>(threads * events);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> thread_counts;
+    uint64_t events = 10000000;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            thread_counts.push_back(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--events" && i + 1 < argc) {
+            events = std::max(1LL, std::atoll(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--threads N]... [--events N]\n";
+            return 2;
+        }
+    }
+    if (thread_counts.empty()) {
+        thread_counts = {1, 2, 4, 8};
+    }
+
+    std::cout << "threads  atomic_ns  counter_ns  histogram_ns  cpu_at_1M_%\n";
+    for (size_t threads : thread_counts) {
+        alignas(kCacheLine) std::atomic<uint64_t> shared{0};
+        const double atomic_ns = Measure(threads, events, [&](uint64_t) {
+            shared.fetch_add(1, std::memory_order_relaxed);
+        });
+
+        MetricsRegistry registry;
+        Counter& counter = registry.counter("bench.events_total");
+        Histogram& histogram = registry.histogram("bench.event_us");
+        const double counter_ns = Measure(threads, events, [&](uint64_t) { counter.inc(); });
+        const double histogram_ns = Measure(threads, events, [&](uint64_t i) { histogram.observe(i & 1023); });
+
+        if (counter.value() != threads * events) {
+            std::cerr << "Counter lost events: " << counter.value() << " of " << threads * events << "\n";
+            return 1;
+        }
+
+        // 1M events/s cost (counter_ns + histogram_ns) * 1e6 ns per second of one core
+        const double cpu_percent = (counter_ns + histogram_ns) * 1e6 / 1e9 * 100.0;
+        std::cout << std::setw(7) << threads << "  " << std::fixed << std::setprecision(1) << std::setw(9)
+                  << atomic_ns << "  " << std::setw(10) << counter_ns << "  " << std::setw(12) << histogram_ns
+                  << "  " << std::setw(11) << std::setprecision(2) << cpu_percent << "\n";
+    }
+    return 0;
+}
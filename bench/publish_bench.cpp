@@ -0,0 +1,165 @@
+/**
+ * publish-bench - databroker publish throughput versus channel count
+ *
+ * Publishes float values to a set of signals through a BrokerPool, the way
+ * fixture-runner does, once for each channel count. Each publish channel is
+ * driven by its own thread and publishes the signals BrokerPool assigns to
+ * it. Prints one line per channel count:
+ *
+ *   channels  publishes/s  mean latency (us)  idle channels
+ *
+ * Needs a running databroker; the signals must exist in its VSS tree.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glog/logging.h>
+#include <kuksa_cpp/kuksa.hpp>
+#include <vss/types/quality.hpp>
+#include "broker_pool.hpp"
+
+using namespace kuksa;
+
+namespace {
+
+struct RunResult {
+    uint64_t publishes = 0;
+    uint64_t failures = 0;
+    double latency_us = 0.0;  // Sum over publishes
+    size_t idle_channels = 0;
+};
+
+RunResult RunOnce(const std::string& address, const std::vector<std::string>& signals, size_t channels,
+               std::chrono::milliseconds duration) {
+    RunResult result;
+    BrokerPool pool(channels);
+    BrokerPool::Connection* connection = pool.get(address);
+    if (!connection) {
+        return result;
+    }
+
+    // Signals of each channel, as the runner assigns them
+    std::vector<std::vector<std::shared_ptr<DynamicSignalHandle>>> assigned(channels);
+    for (const auto& signal : signals) {
+        auto handle = connection->resolver->get_dynamic(signal);
+        if (!handle.ok()) {
+            LOG(ERROR) << "Failed to resolve " << signal << ": " << handle.status();
+            return result;
+        }
+        assigned[connection->channel_for(signal)].push_back(*handle);
+    }
+    if (!pool.start(std::chrono::seconds(10))) {
+        return result;
+    }
+
+    std::atomic<uint64_t> publishes{0};
+    std::atomic<uint64_t> failures{0};
+    std::atomic<uint64_t> latency_ns{0};
+    const auto stop_at = std::chrono::steady_clock::now() + duration;
+    std::vector<std::thread> threads;
+    for (size_t c = 0; c < channels; ++c) {
+        if (assigned[c].empty()) {
+            ++result.idle_channels;
+            continue;
+        }
+        threads.emplace_back([&, c] {
+            Client& client = *connection->publishers[c];
+            uint64_t count = 0;
+            uint64_t failed = 0;
+            uint64_t nanos = 0;
+            for (size_t i = 0; std::chrono::steady_clock::now() < stop_at; ++i) {
+                vss::types::QualifiedValue<vss::types::Value> value;
+                value.value = static_cast<float>(i % 1000);
+                value.quality = vss::types::SignalQuality::VALID;
+                value.timestamp = std::chrono::system_clock::now();
+
+                const auto start = std::chrono::steady_clock::now();
+                auto status = client.publish(*assigned[c][i % assigned[c].size()], value);
+                nanos += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+                ++count;
+                failed += status.ok() ? 0 : 1;
+            }
+            publishes += count;
+            failures += failed;
+            latency_ns += nanos;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    pool.stop();
+
+    result.publishes = publishes;
+    result.failures = failures;
+    result.latency_us = static_cast<double>(latency_ns) / 1000.0;
+    return result;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    google::InitGoogleLogging(argv[0]);
+    FLAGS_logtostderr = 1;
+
+    std::string address = "localhost:55555";
+    std::vector<std::string> signals;
+    std::vector<size_t> channel_counts;
+    std::chrono::milliseconds duration(5000);
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--kuksa" && i + 1 < argc) {
+            address = argv[++i];
+        } else if (arg == "--signal" && i + 1 < argc) {
+            signals.push_back(argv[++i]);
+        } else if (arg == "--channels" && i + 1 < argc) {
+            channel_counts.push_back(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--duration-ms" && i + 1 < argc) {
+            duration = std::chrono::milliseconds(std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--kuksa ADDR] [--signal PATH]... [--channels N]..."
+                      << " [--duration-ms N]\n";
+            return 2;
+        }
+    }
+    if (signals.empty()) {
+        signals = {
+            "Vehicle.Speed",
+            "Vehicle.Exterior.AirTemperature",
+            "Vehicle.Exterior.Humidity",
+            "Vehicle.Cabin.HVAC.AmbientAirTemperature",
+            "Vehicle.Powertrain.TractionBattery.CurrentVoltage",
+            "Vehicle.Powertrain.TractionBattery.CurrentCurrent",
+            "Vehicle.Powertrain.TractionBattery.StateOfCharge.Current",
+            "Vehicle.Chassis.Axle.Row1.Wheel.Left.Tire.Pressure",
+        };
+    }
+    if (channel_counts.empty()) {
+        channel_counts = {1, 2, 4, 8};
+    }
+
+    std::cout << "channels  publishes/s  mean_latency_us  idle_channels\n";
+    for (size_t channels : channel_counts) {
+        const RunResult result = RunOnce(address, signals, channels, duration);
+        if (result.publishes == 0) {
+            std::cerr << "No publishes with " << channels << " channel(s)\n";
+            return 1;
+        }
+        if (result.failures > 0) {
+            std::cerr << result.failures << " publish(es) failed with " << channels << " channel(s)\n";
+        }
+        const double seconds = std::chrono::duration<double>(duration).count();
+        std::cout << std::setw(8) << channels << "  " << std::setw(11) << std::fixed << std::setprecision(0)
+                  << result.publishes / seconds << "  " << std::setw(15) << std::setprecision(1)
+                  << result.latency_us / result.publishes << "  " << std::setw(13) << result.idle_channels << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,27 @@
+# fixture_runner_add_codegen_fixture(<target> <fixture.yaml>)
+#
+# Builds <target>, a fixture runner with the native mappings of <fixture.yaml>
+# compiled in by fixture-codegen. The binary takes the same arguments as
+# fixture-runner; it uses the compiled program when --config points at a YAML
+# with the same native mappings and the generic path otherwise.
+
+set(FIXTURE_RUNNER_MAIN_SOURCE "${CMAKE_CURRENT_LIST_DIR}/../src/fixture_runner.cpp")
+
+function(fixture_runner_add_codegen_fixture target yaml)
+    get_filename_component(yaml_path "${yaml}" ABSOLUTE)
+    set(generated "${CMAKE_CURRENT_BINARY_DIR}/${target}_fixture.cpp")
+
+    add_custom_command(
+        OUTPUT "${generated}"
+        COMMAND fixture-codegen --config "${yaml_path}" --output "${generated}"
+        DEPENDS fixture-codegen "${yaml_path}"
+        COMMENT "Generating native fixture program for ${target}"
+        VERBATIM
+    )
+
+    add_executable(${target}
+        ${FIXTURE_RUNNER_MAIN_SOURCE}
+        "${generated}"
+    )
+    target_link_libraries(${target} PRIVATE fixture-runner-core)
+endfunction()
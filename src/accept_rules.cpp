@@ -0,0 +1,95 @@
+#include "accept_rules.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include "native_graph.hpp"
+
+const char* AcceptRules::check(const vss::types::Value& value, std::chrono::steady_clock::time_point now) {
+    const std::optional<double> number = NativeValueFromVss(value);
+
+    if (!strings_.empty() || !numbers_.empty()) {
+        const auto* text = std::get_if<std::string>(&value);
+        const bool listed =
+            (text && std::find(strings_.begin(), strings_.end(), *text) != strings_.end()) ||
+            (number && std::find(numbers_.begin(), numbers_.end(), *number) != numbers_.end());
+        if (!listed) {
+            return "value not allowed";
+        }
+    }
+
+    if (min_ || max_ || max_rate_) {
+        if (!number || std::isnan(*number)) {
+            return "value not numeric";
+        }
+        if ((min_ && *number < *min_) || (max_ && *number > *max_)) {
+            return "value out of range";
+        }
+    }
+
+    if (max_rate_ && number) {
+        if (last_value_) {
+            const double dt = std::chrono::duration<double>(now - last_time_).count();
+            if (std::fabs(*number - *last_value_) > *max_rate_ * dt) {
+                return "value changes too fast";
+            }
+        }
+        last_value_ = number;
+        last_time_ = now;
+    }
+    return nullptr;
+}
+
+void AcceptRules::prime(const vss::types::Value& value, std::chrono::steady_clock::time_point now) {
+    if (max_rate_) {
+        if (const std::optional<double> number = NativeValueFromVss(value)) {
+            last_value_ = number;
+            last_time_ = now;
+        }
+    }
+}
+
+std::optional<std::string> AcceptRules::Parse(const YAML::Node& node, AcceptRules& rules) {
+    if (!node.IsMap()) {
+        return "'accept' must be a map";
+    }
+    try {
+        for (const auto& entry : node) {
+            const std::string key = entry.first.as<std::string>();
+            const YAML::Node& value = entry.second;
+            if (key == "min") {
+                rules.min_ = value.as<double>();
+            } else if (key == "max") {
+                rules.max_ = value.as<double>();
+            } else if (key == "max_rate") {
+                rules.max_rate_ = value.as<double>();
+                if (!(*rules.max_rate_ >= 0.0)) {
+                    return "max_rate must not be negative";
+                }
+            } else if (key == "values") {
+                if (!value.IsSequence() || value.size() == 0) {
+                    return "'values' must be a non-empty list";
+                }
+                // An entry matches string commands by text, numeric and boolean ones by value.
+                // Entries are read as text, so enum names like ON / OFF stay strings.
+                for (const auto& item : value) {
+                    const std::string text = item.as<std::string>();
+                    rules.strings_.push_back(text);
+                    double number;
+                    if (text == "true" || text == "false") {
+                        rules.numbers_.push_back(text == "true" ? 1.0 : 0.0);
+                    } else if (YAML::convert<double>::decode(item, number)) {
+                        rules.numbers_.push_back(number);
+                    }
+                }
+            } else {
+                return "unknown accept rule '" + key + "'";
+            }
+        }
+    } catch (const YAML::Exception& e) {
+        return std::string("invalid accept rule: ") + e.what();
+    }
+    if (rules.min_ && rules.max_ && *rules.min_ > *rules.max_) {
+        return "min is greater than max";
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+#include <vss/types/value.hpp>
+
+/**
+ * @brief Checks a served actuator's commands before they are queued
+ *
+ * Emulates ECUs that refuse out-of-range or implausible commands. All rules
+ * are optional; a command must pass every rule that is set:
+ *
+ *   min / max   numeric or boolean value within [min, max]
+ *   values      value equal to one of a list of numbers or strings
+ *   max_rate    change from the last accepted command, per second since it
+ *
+ * Not thread-safe; the runner checks under its ingress lock so the rate is
+ * measured in queue order.
+ */
+class AcceptRules {
+public:
+    bool empty() const {
+        return !min_ && !max_ && numbers_.empty() && strings_.empty() && !max_rate_;
+    }
+
+    /**
+     * @brief Check |value|, commanded at |now|
+     * @return why it is rejected, or nullptr if it is accepted
+     */
+    const char* check(const vss::types::Value& value, std::chrono::steady_clock::time_point now);
+
+    // Take |value|, set at |now| without a command (an initial value), as
+    // the last accepted one, so max_rate limits the first command too
+    void prime(const vss::types::Value& value, std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Parse an 'accept' node into |rules|
+     * @return error message, or nullopt on success
+     */
+    static std::optional<std::string> Parse(const YAML::Node& node, AcceptRules& rules);
+
+private:
+    std::optional<double> min_;
+    std::optional<double> max_;
+    std::vector<double> numbers_;
+    std::vector<std::string> strings_;
+    std::optional<double> max_rate_;  // Units per second
+
+    // Last accepted command, for max_rate
+    std::optional<double> last_value_;
+    std::chrono::steady_clock::time_point last_time_;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+/**
+ * @brief Decides how long the DAG owner accumulates actuations before a pass
+ *
+ * At low load every actuation is evaluated immediately. Once the ingress
+ * queue backs up, a short window is opened so that a burst is evaluated as a
+ * single process_signal_updates() call. The window grows with the smoothed
+ * queue depth and is capped by max_wait / max_batch.
+ */
+class AdaptiveBatchWindow {
+public:
+    struct Options {
+        size_t immediate_depth = 1;                 // Depth at or below which no window is opened
+        size_t max_batch = 256;                     // Size budget of one DAG pass
+        std::chrono::microseconds max_wait{2000};   // Time budget of one window
+    };
+
+    AdaptiveBatchWindow() = default;
+    explicit AdaptiveBatchWindow(Options options) : options_(options) {}
+
+    const Options& options() const { return options_; }
+
+    /**
+     * @brief Window to wait for more actuations, given the current queue depth
+     * @return zero when the batch should be evaluated right away
+     */
+    std::chrono::microseconds window_for(size_t depth) {
+        // EWMA of observed depth so a single burst does not pin the window open
+        load_ += (static_cast<double>(depth) - load_) * kSmoothing;
+
+        if (depth <= options_.immediate_depth && load_ <= options_.immediate_depth) {
+            return std::chrono::microseconds(0);
+        }
+        if (depth >= options_.max_batch) {
+            return std::chrono::microseconds(0);
+        }
+
+        const double fill = std::min(1.0, load_ / static_cast<double>(options_.max_batch));
+        return std::chrono::microseconds(
+            std::max<long long>(1, static_cast<long long>(options_.max_wait.count() * fill)));
+    }
+
+private:
+    static constexpr double kSmoothing = 0.25;
+
+    Options options_;
+    double load_ = 0.0;
+};
@@ -0,0 +1,120 @@
+#include "broker_pool.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <glog/logging.h>
+#include <grpcpp/grpcpp.h>
+
+using namespace kuksa;
+
+size_t BrokerPool::Connection::channel_for(const std::string& signal) const {
+    return std::hash<std::string>()(signal) % publishers.size();
+}
+
+BrokerPool::BrokerPool(size_t publish_channels) : publish_channels_(std::max<size_t>(1, publish_channels)) {}
+
+BrokerPool::~BrokerPool() {
+    stop();
+}
+
+BrokerPool::Connection* BrokerPool::get(const std::string& address) {
+    auto it = connections_.find(address);
+    if (it != connections_.end()) {
+        return it->second.get();
+    }
+
+    // The resolver and clients connect lazily, so a broker that is down would
+    // only show up as a failed resolve
+    if (!reachable(address)) {
+        LOG(ERROR) << "Databroker " << address << " is not reachable";
+        return nullptr;
+    }
+
+    auto resolver_result = Resolver::create(address);
+    if (!resolver_result.ok()) {
+        LOG(ERROR) << "Failed to create resolver for " << address << ": " << resolver_result.status();
+        return nullptr;
+    }
+    auto client_result = Client::create(address);
+    if (!client_result.ok()) {
+        LOG(ERROR) << "Failed to create client for " << address << ": " << client_result.status();
+        return nullptr;
+    }
+
+    auto connection = std::make_unique<Connection>();
+    connection->address = address;
+    connection->resolver = std::move(*resolver_result);
+    connection->client = std::move(*client_result);
+    connection->publishers.push_back(connection->client);
+    while (connection->publishers.size() < publish_channels_) {
+        auto publisher_result = Client::create(address);
+        if (!publisher_result.ok()) {
+            LOG(ERROR) << "Failed to create publish client for " << address << ": " << publisher_result.status();
+            return nullptr;
+        }
+        connection->publishers.push_back(std::move(*publisher_result));
+    }
+    LOG(INFO) << "Connecting to databroker " << address << " (" << publish_channels_ << " publish channel(s))";
+    return connections_.emplace(address, std::move(connection)).first->second.get();
+}
+
+bool BrokerPool::reachable(const std::string& address, std::chrono::milliseconds timeout) {
+    auto channel = grpc::CreateChannel(address, grpc::InsecureChannelCredentials());
+    return channel->WaitForConnected(std::chrono::system_clock::now() + timeout);
+}
+
+bool BrokerPool::claim(const std::string& address, const std::string& actuator, const std::string& fixture) {
+    auto [it, inserted] = owners_[address].emplace(actuator, fixture);
+    if (!inserted) {
+        LOG(ERROR) << "Actuator " << actuator << " on " << address << " is served by both '"
+                   << it->second << "' and '" << fixture << "'";
+        return false;
+    }
+    return true;
+}
+
+bool BrokerPool::start(std::chrono::milliseconds timeout, std::string* failed_address) {
+    for (auto& [address, connection] : connections_) {
+        for (auto& client : connection->publishers) {
+            auto start_status = client->start();
+            if (!start_status.ok()) {
+                LOG(ERROR) << "Failed to start client for " << address << ": " << start_status;
+                if (failed_address) {
+                    *failed_address = address;
+                }
+                return false;
+            }
+        }
+    }
+    started_ = true;
+
+    // Clients connect concurrently; each wait only covers what is left
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (auto& [address, connection] : connections_) {
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        for (auto& client : connection->publishers) {
+            auto ready_status = client->wait_until_ready(std::max(left, std::chrono::milliseconds(0)));
+            if (!ready_status.ok()) {
+                LOG(ERROR) << "Client for " << address << " not ready: " << ready_status;
+                if (failed_address) {
+                    *failed_address = address;
+                }
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void BrokerPool::stop() {
+    if (!started_) {
+        return;
+    }
+    started_ = false;
+    for (auto& [address, connection] : connections_) {
+        for (auto& client : connection->publishers) {
+            client->stop();
+        }
+    }
+}
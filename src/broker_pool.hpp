@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <kuksa_cpp/kuksa.hpp>
+
+/**
+ * @brief Databroker connections of a runner process, one per address
+ *
+ * Fixtures routed to the same broker share its resolver and client, so a
+ * process serving several fixtures opens one connection per broker rather
+ * than one per fixture. Clients are started together once every fixture has
+ * registered its actuators.
+ *
+ * Publishing can be spread over several clients per broker, each with its
+ * own gRPC channel. A signal always uses the same one, so its values stay in
+ * order.
+ */
+class BrokerPool {
+public:
+    struct Connection {
+        std::string address;
+        std::unique_ptr<kuksa::Resolver> resolver;
+        std::shared_ptr<kuksa::Client> client;  // Serves actuators; also publishers[0]
+        std::vector<std::shared_ptr<kuksa::Client>> publishers;
+
+        // Index of the publisher for |signal|
+        size_t channel_for(const std::string& signal) const;
+    };
+
+    explicit BrokerPool(size_t publish_channels = 1);
+    ~BrokerPool();
+
+    BrokerPool(const BrokerPool&) = delete;
+    BrokerPool& operator=(const BrokerPool&) = delete;
+
+    /**
+     * @brief Connection to |address|, created on first use
+     * @return nullptr if the broker does not answer or the resolver or
+     *         client could not be created (logged)
+     */
+    Connection* get(const std::string& address);
+
+    // Whether a gRPC channel to |address| connects within |timeout|
+    static bool reachable(const std::string& address,
+                          std::chrono::milliseconds timeout = std::chrono::seconds(5));
+
+    /**
+     * @brief Claim |actuator| on |address| for |fixture|
+     * @return false if another fixture of this process already serves it there (logged)
+     */
+    bool claim(const std::string& address, const std::string& actuator, const std::string& fixture);
+
+    // Start every client and wait until each is ready; on failure the
+    // address not ready is stored in |failed_address| if given
+    bool start(std::chrono::milliseconds timeout, std::string* failed_address = nullptr);
+
+    void stop();
+
+    size_t size() const { return connections_.size(); }
+
+private:
+    std::map<std::string, std::unique_ptr<Connection>> connections_;
+    std::map<std::string, std::unordered_map<std::string, std::string>> owners_;  // Address -> actuator -> fixture
+    size_t publish_channels_;
+    bool started_ = false;
+};
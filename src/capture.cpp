@@ -0,0 +1,297 @@
+#include "capture.hpp"
+
+#include <cstring>
+#include <glog/logging.h>
+#include "gorilla.hpp"
+
+namespace {
+
+template <typename T>
+void Put(std::FILE* file, T value) {
+    std::fwrite(&value, sizeof(value), 1, file);
+}
+
+template <typename T>
+bool Get(std::FILE* file, T& value) {
+    return std::fread(&value, sizeof(value), 1, file) == 1;
+}
+
+// Anything larger is a damaged length field, not a real chunk
+constexpr uint32_t kMaxChunkBytes = 64u << 20;
+
+}  // namespace
+
+CaptureWriter::CaptureWriter(const std::string& path, MetricsRegistry& metrics,
+                             std::chrono::milliseconds flush_interval)
+    : flush_interval_(flush_interval),
+      points_total_(metrics.counter("capture.points_total")),
+      chunks_total_(metrics.counter("capture.chunks_total")),
+      bytes_total_(metrics.counter("capture.bytes_total")) {
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        LOG(ERROR) << "Cannot open capture file " << path << ": " << std::strerror(errno);
+        return;
+    }
+    std::fwrite(capture::kMagic, sizeof(capture::kMagic), 1, file_);
+    Put(file_, capture::kVersion);
+    thread_ = std::thread([this] { Loop(); });
+}
+
+CaptureWriter::~CaptureWriter() {
+    if (!file_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+    std::fclose(file_);
+}
+
+void CaptureWriter::record(const std::string& signal, int64_t timestamp_us, double value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = columns_.find(signal);
+    if (it == columns_.end()) {
+        Column column;
+        column.id = static_cast<uint32_t>(columns_.size());
+        column.points.reserve(kChunkPoints);
+        it = columns_.emplace(signal, std::move(column)).first;
+    }
+    it->second.points.emplace_back(timestamp_us, value);
+    points_total_.inc();
+    if (it->second.points.size() >= kChunkPoints) {
+        SealLocked(signal, it->second);
+        cv_.notify_one();
+    }
+}
+
+void CaptureWriter::record_seed(const std::string& fixture, uint64_t seed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    seeds_.emplace_back(fixture, seed);
+    cv_.notify_one();
+}
+
+void CaptureWriter::SealLocked(const std::string& signal, Column& column) {
+    Sealed sealed{column.id, column.declared ? std::string() : signal, std::move(column.points)};
+    column.declared = true;
+    column.points.clear();
+    column.points.reserve(kChunkPoints);
+    sealed_.push_back(std::move(sealed));
+}
+
+void CaptureWriter::Loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto next_flush = std::chrono::steady_clock::now() + flush_interval_;
+    while (true) {
+        cv_.wait_until(lock, next_flush, [this] { return stopping_ || !sealed_.empty() || !seeds_.empty(); });
+
+        // Partial columns go out once per interval, and everything on stop
+        const bool flush = stopping_ || std::chrono::steady_clock::now() >= next_flush;
+        if (flush) {
+            for (auto& [signal, column] : columns_) {
+                if (!column.points.empty()) {
+                    SealLocked(signal, column);
+                }
+            }
+            next_flush = std::chrono::steady_clock::now() + flush_interval_;
+        }
+
+        std::deque<Sealed> batch;
+        batch.swap(sealed_);
+        std::vector<std::pair<std::string, uint64_t>> seeds;
+        seeds.swap(seeds_);
+        const bool stopping = stopping_;
+        lock.unlock();
+        for (const auto& [fixture, seed] : seeds) {
+            Put(file_, capture::kSeedRecord);
+            Put(file_, uint32_t{0});
+            Put(file_, static_cast<uint16_t>(fixture.size()));
+            std::fwrite(fixture.data(), 1, fixture.size(), file_);
+            Put(file_, seed);
+        }
+        for (const auto& sealed : batch) {
+            Write(sealed);
+        }
+        if (flush) {
+            std::fflush(file_);
+        }
+        lock.lock();
+
+        if (stopping && sealed_.empty()) {
+            break;
+        }
+    }
+}
+
+void CaptureWriter::Write(const Sealed& sealed) {
+    if (!sealed.declare.empty()) {
+        Put(file_, capture::kSignalRecord);
+        Put(file_, sealed.id);
+        Put(file_, static_cast<uint16_t>(sealed.declare.size()));
+        std::fwrite(sealed.declare.data(), 1, sealed.declare.size(), file_);
+    }
+
+    GorillaEncoder encoder;
+    for (const auto& [timestamp_us, value] : sealed.points) {
+        encoder.append(timestamp_us, value);
+    }
+    Put(file_, capture::kChunkRecord);
+    Put(file_, sealed.id);
+    Put(file_, static_cast<uint32_t>(encoder.count()));
+    Put(file_, static_cast<int64_t>(encoder.first_timestamp()));
+    Put(file_, static_cast<uint32_t>(encoder.bytes().size()));
+    std::fwrite(encoder.bytes().data(), 1, encoder.bytes().size(), file_);
+
+    chunks_total_.inc();
+    bytes_total_.inc(encoder.bytes().size());
+    if (std::ferror(file_)) {
+        LOG_EVERY_N(WARNING, 100) << "Writing capture file failed";
+    }
+}
+
+CaptureReader::CaptureReader(const std::string& path) : path_(path) {
+    file_ = std::fopen(path.c_str(), "rb");
+    if (!file_) {
+        error_ = "cannot open " + path + ": " + std::strerror(errno);
+        return;
+    }
+    char magic[sizeof(capture::kMagic)];
+    uint32_t version = 0;
+    if (std::fread(magic, sizeof(magic), 1, file_) != 1 ||
+        std::memcmp(magic, capture::kMagic, sizeof(magic)) != 0 || !Get(file_, version)) {
+        error_ = path + " is not a capture file";
+        return;
+    }
+    if (version < 1 || version > capture::kVersion) {
+        error_ = path + " has unsupported capture version " + std::to_string(version);
+    }
+}
+
+CaptureReader::~CaptureReader() {
+    if (file_) {
+        std::fclose(file_);
+    }
+}
+
+// A record cut short by the end of the file is what a writer that did not
+// get to close leaves behind; the records before it are intact, so it ends
+// the file. Short reads anywhere else are damage.
+bool CaptureReader::Truncated(const char* what, bool warn) {
+    if (!std::feof(file_)) {
+        error_ = path_ + ": truncated " + what;
+        return false;
+    }
+    if (warn) {
+        LOG(WARNING) << path_ << ": ignoring partial " << what << " at the end of the file";
+    }
+    return false;
+}
+
+bool CaptureReader::ReadRecord(Chunk& chunk, bool with_data, bool& is_chunk) {
+    uint8_t type;
+    uint32_t id;
+    if (!Get(file_, type)) {
+        return false;  // Clean end of file
+    }
+    if (!Get(file_, id)) {
+        return Truncated("record", with_data);
+    }
+
+    if (type == capture::kSignalRecord || type == capture::kSeedRecord) {
+        const char* what = type == capture::kSignalRecord ? "signal record" : "seed record";
+        uint16_t length;
+        std::string name;
+        if (!Get(file_, length)) {
+            return Truncated(what, with_data);
+        }
+        name.resize(length);
+        if (length > 0 && std::fread(name.data(), 1, length, file_) != length) {
+            return Truncated(what, with_data);
+        }
+        is_chunk = false;
+        if (type == capture::kSignalRecord) {
+            names_[id] = std::move(name);
+            return true;
+        }
+        uint64_t seed;
+        if (!Get(file_, seed)) {
+            return Truncated("seed record", with_data);
+        }
+        seeds_[name] = seed;
+        return true;
+    }
+    if (type != capture::kChunkRecord) {
+        error_ = path_ + ": unknown record type " + std::to_string(type);
+        return false;
+    }
+
+    uint32_t count;
+    int64_t first_timestamp;
+    uint32_t size;
+    if (!Get(file_, count) || !Get(file_, first_timestamp) || !Get(file_, size)) {
+        return Truncated("chunk record", with_data);
+    }
+    if (size > kMaxChunkBytes) {
+        error_ = path_ + ": damaged chunk record";
+        return false;
+    }
+    auto name = names_.find(id);
+    if (name == names_.end()) {
+        error_ = path_ + ": chunk for undeclared signal " + std::to_string(id);
+        return false;
+    }
+    is_chunk = true;
+    chunk.signal = &name->second;
+    chunk.count = count;
+    chunk.first_timestamp_us = first_timestamp;
+    if (!with_data) {
+        return std::fseek(file_, size, SEEK_CUR) == 0;
+    }
+    chunk.bytes.resize(size);
+    if (size > 0 && std::fread(chunk.bytes.data(), 1, size, file_) != size) {
+        return Truncated("chunk data", with_data);
+    }
+    return true;
+}
+
+bool CaptureReader::next(Chunk& chunk) {
+    if (!file_ || !error_.empty()) {
+        return false;
+    }
+    bool is_chunk = false;
+    while (ReadRecord(chunk, true, is_chunk)) {
+        if (is_chunk) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::optional<int64_t> CaptureReader::start_timestamp(size_t lookahead) {
+    if (!file_ || !error_.empty()) {
+        return std::nullopt;
+    }
+    const long position = std::ftell(file_);
+
+    // Chunk headers only; the data is skipped
+    std::optional<int64_t> start;
+    Chunk header;
+    size_t seen = 0;
+    bool is_chunk = false;
+    while (seen < lookahead && ReadRecord(header, false, is_chunk)) {
+        if (!is_chunk) {
+            continue;
+        }
+        ++seen;
+        if (!start || header.first_timestamp_us < *start) {
+            start = header.first_timestamp_us;
+        }
+    }
+
+    // Names read ahead stay known; reading them again is harmless
+    std::fseek(file_, position, SEEK_SET);
+    error_.clear();
+    return start;
+}
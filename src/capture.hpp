@@ -0,0 +1,156 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "metrics.hpp"
+
+/**
+ * Capture files
+ *
+ * Every published actual value, stored per signal in Gorilla-compressed
+ * chunks (see gorilla.hpp) for analysis after a run. Layout, little-endian:
+ *
+ *   "FXCP" uint32 version (2)
+ *   records, each starting with a uint8 type:
+ *     1  SIGNAL  uint32 id, uint16 name length, name bytes
+ *     2  CHUNK   uint32 id, uint32 point count, int64 first timestamp (us
+ *                since the Unix epoch), uint32 byte length, Gorilla bytes
+ *     3  SEED    uint32 0, uint16 fixture name length, name bytes, uint64
+ *                the fixture's random seed (version 2)
+ *
+ * A SIGNAL record precedes the first chunk of its id. Chunks of one signal
+ * are in time order; chunks of different signals interleave, and as every
+ * column is written at least once per flush interval, a point is never
+ * written more than about one interval after a later point of another
+ * signal. Version 1 files are read too; they have no SEED records.
+ */
+namespace capture {
+
+constexpr char kMagic[4] = {'F', 'X', 'C', 'P'};
+constexpr uint32_t kVersion = 2;
+constexpr uint8_t kSignalRecord = 1;
+constexpr uint8_t kChunkRecord = 2;
+constexpr uint8_t kSeedRecord = 3;
+
+// How often the runner's writer hands every non-empty column to the disk
+constexpr std::chrono::milliseconds kFlushInterval{1000};
+
+}  // namespace capture
+
+/**
+ * @brief Writes a capture file from the publishing thread's point of view
+ *
+ * record() only appends to an in-memory column. Full columns, and once per
+ * flush interval all non-empty ones, are handed to a background thread that
+ * encodes and writes them, so the publish path never touches the disk.
+ */
+class CaptureWriter {
+public:
+    static constexpr size_t kChunkPoints = 1024;
+
+    CaptureWriter(const std::string& path, MetricsRegistry& metrics,
+                  std::chrono::milliseconds flush_interval = capture::kFlushInterval);
+    ~CaptureWriter();  // Flushes everything recorded so far
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    bool ok() const { return file_ != nullptr; }
+
+    void record(const std::string& signal, int64_t timestamp_us, double value);
+
+    // Note the random seed |fixture| runs with, so the run can be repeated
+    void record_seed(const std::string& fixture, uint64_t seed);
+
+private:
+    using Points = std::vector<std::pair<int64_t, double>>;
+
+    struct Column {
+        uint32_t id;
+        bool declared = false;
+        Points points;
+    };
+
+    struct Sealed {
+        uint32_t id;
+        std::string declare;  // Signal name if its SIGNAL record is still due
+        Points points;
+    };
+
+    void SealLocked(const std::string& signal, Column& column);
+    void Loop();
+    void Write(const Sealed& sealed);
+
+    std::FILE* file_ = nullptr;
+    std::chrono::milliseconds flush_interval_;
+    Counter& points_total_;
+    Counter& chunks_total_;
+    Counter& bytes_total_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::unordered_map<std::string, Column> columns_;
+    std::deque<Sealed> sealed_;
+    std::vector<std::pair<std::string, uint64_t>> seeds_;  // Not yet written
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+/**
+ * @brief Reads a capture file one chunk at a time
+ *
+ * Memory use is one chunk plus the signal names, whatever the file size.
+ */
+class CaptureReader {
+public:
+    struct Chunk {
+        const std::string* signal = nullptr;
+        uint32_t count = 0;
+        int64_t first_timestamp_us = 0;
+        std::vector<uint8_t> bytes;  // Decode with GorillaDecoder(bytes, count)
+    };
+
+    explicit CaptureReader(const std::string& path);
+    ~CaptureReader();
+
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    // Empty when the file opened and has a valid header
+    const std::string& error() const { return error_; }
+
+    // Next chunk in file order; false at the end or on a damaged record (see
+    // error()). A partial record at the very end, as left by a writer that
+    // was killed, ends the file with a warning.
+    bool next(Chunk& chunk);
+
+    // Fixture seeds of the SEED records read so far. Runners record them at
+    // startup, so they are all known once the first chunk has been read.
+    const std::map<std::string, uint64_t>& seeds() const { return seeds_; }
+
+    // Earliest chunk start among the first |lookahead| chunks, without moving
+    // the read position. Captures flush all signals together, so this is the
+    // start of the recording.
+    std::optional<int64_t> start_timestamp(size_t lookahead = 256);
+
+private:
+    bool ReadRecord(Chunk& chunk, bool with_data, bool& is_chunk);
+    bool Truncated(const char* what, bool warn);
+
+    std::FILE* file_ = nullptr;
+    std::string path_;
+    std::string error_;
+    std::unordered_map<uint32_t, std::string> names_;
+    std::map<std::string, uint64_t> seeds_;
+};
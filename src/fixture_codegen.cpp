@@ -0,0 +1,364 @@
+/**
+ * fixture-codegen - compile a native fixture into C++
+ *
+ * Turns a fixture YAML whose mappings all use native transforms into a C++
+ * source file: the graph is wired at compile time into straight-line code
+ * with fixed slots, no interpreter dispatch and no hash map lookups. Linking
+ * the file into a runner (see fixture_runner_add_codegen_fixture() in
+ * cmake/FixtureCodegen.cmake) makes that runner use it whenever it loads the
+ * same YAML; any other fixture falls back to the generic path.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <glog/logging.h>
+#include "fixture_config.hpp"
+#include "native_graph.hpp"
+
+namespace {
+
+std::string CppString(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out + "\"";
+}
+
+std::string CppDouble(double v) {
+    char buf[40];
+    std::snprintf(buf, sizeof(buf), "%.17g", v);
+    std::string text = buf;
+    if (text.find_first_of(".eEn") == std::string::npos) {
+        text += ".0";
+    }
+    return text;
+}
+
+std::string SlotName(const NativeGraphSpec& spec, uint32_t slot) {
+    if (slot < spec.inputs.size()) {
+        return spec.inputs[slot] + " (command)";
+    }
+    return spec.nodes[slot - spec.inputs.size()].mapping.signal;
+}
+
+// Key of noise node |k|'s random stream: a constant if the mapping sets its
+// own seed, else a member keyed from the fixture seed at create()
+std::string NoiseKey(const NativeMappingSpec& mapping, size_t k) {
+    return mapping.own_seed ? "kKey" + std::to_string(k) : "key" + std::to_string(k) + "_";
+}
+
+// Emit the evaluation of node |k|; sets `produced` when the node has a new value
+void EmitNode(std::ostream& out, const NativeGraphSpec& spec, size_t k) {
+    const auto& node = spec.nodes[k];
+    const auto& mapping = node.mapping;
+    const uint32_t in = node.input_slots[0];
+    const uint32_t slot = spec.node_slot(k);
+    const std::string x = "values_[" + std::to_string(in) + "]";
+    const std::string y = "values_[" + std::to_string(slot) + "]";
+    const std::string changed = "dirty_[" + std::to_string(in) + "]";
+
+    out << "        // [" << k << "] " << mapping.signal << " = " << NativeKindName(mapping.kind)
+        << "(" << SlotName(spec, in) << ")\n";
+
+    switch (mapping.kind) {
+        case NativeKind::COPY:
+            out << "        if (" << changed << ") {\n"
+                << "            " << y << " = fixture_native::copy_step(" << x << ", "
+                << CppDouble(mapping.param("scale", 1.0)) << ", "
+                << CppDouble(mapping.param("offset", 0.0)) << ");\n"
+                << "            Produce(" << k << ", outputs);\n"
+                << "        }\n";
+            break;
+        case NativeKind::DELAYED:
+            out << "        if (" << changed << ") {\n"
+                << "            fixture_native::delayed_arm(state" << k << "_, " << x << ", now, kDelay" << k << ");\n"
+                << "        }\n"
+                << "        if (fixture_native::delayed_fire(state" << k << "_, now, " << y << ")) {\n"
+                << "            Produce(" << k << ", outputs);\n"
+                << "        }\n";
+            break;
+        case NativeKind::PLUGIN:
+        case NativeKind::PLAYBACK:
+            break;  // Rejected before emission
+        case NativeKind::LOWPASS:
+        case NativeKind::MOVING_AVERAGE:
+        case NativeKind::DERIVATIVE:
+        case NativeKind::NOISE: {
+            const std::string n = std::to_string(k);
+            out << "        if (fixture_native::sample_active(" << changed << ", now_s, kPeriod" << n
+                << ", next_sample" << n << "_)) {\n";
+            if (mapping.kind == NativeKind::LOWPASS) {
+                out << "            " << y << " = fixture_native::lowpass_step(" << y << ", " << x << ", "
+                    << CppDouble(mapping.param("alpha", 0.5)) << ", primed" << n << "_);\n"
+                    << "            primed" << n << "_ = true;\n";
+            } else if (mapping.kind == NativeKind::MOVING_AVERAGE) {
+                out << "            " << y << " = fixture_native::moving_average_step(ring" << n
+                    << "_.data(), static_cast<uint32_t>(ring" << n << "_.size()), head" << n << "_, count" << n
+                    << "_, sum" << n << "_, " << x << ");\n";
+            } else if (mapping.kind == NativeKind::DERIVATIVE) {
+                out << "            " << y << " = fixture_native::derivative_step(" << x << ", prev_x" << n
+                    << "_, now_s - prev_t" << n << "_, primed" << n << "_);\n"
+                    << "            prev_x" << n << "_ = " << x << ";\n"
+                    << "            prev_t" << n << "_ = now_s;\n"
+                    << "            primed" << n << "_ = true;\n";
+            } else {
+                out << "            " << y << " = fixture_native::noise_step(" << x << ", "
+                    << CppDouble(mapping.param("stddev", 1.0)) << ", " << NoiseKey(mapping, k) << ", counter" << n
+                    << "_++);\n";
+            }
+            out << "            Produce(" << k << ", outputs);\n"
+                << "        }\n";
+            break;
+        }
+        case NativeKind::SUSTAINED_CONDITION:
+            out << "        {\n"
+                << "            const double next = fixture_native::sustained_step(" << x << " != 0.0, now_s, kDuration"
+                << k << ", since" << k << "_);\n"
+                << "            if (" << changed << " || next != " << y << ") {\n"
+                << "                " << y << " = next;\n"
+                << "                Produce(" << k << ", outputs);\n"
+                << "            }\n"
+                << "        }\n";
+            break;
+    }
+}
+
+// Constants for node |k|, emitted at namespace scope
+void EmitNodeConstants(std::ostream& out, const NativeGraphSpec& spec, size_t k) {
+    const auto& mapping = spec.nodes[k].mapping;
+    if (mapping.kind == NativeKind::DELAYED) {
+        out << "constexpr Clock::duration kDelay" << k
+            << " = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>("
+            << CppDouble(mapping.param("delay_ms", 0.0)) << "));\n";
+    }
+    if (IsFilterKind(mapping.kind) && mapping.kind != NativeKind::SUSTAINED_CONDITION) {
+        const double rate_hz = mapping.param("rate_hz", 0.0);
+        out << "constexpr double kPeriod" << k << " = " << CppDouble(rate_hz > 0.0 ? 1.0 / rate_hz : 0.0) << ";\n";
+    }
+    if (mapping.kind == NativeKind::SUSTAINED_CONDITION) {
+        out << "constexpr double kDuration" << k << " = " << CppDouble(mapping.param("duration_ms", 0.0) / 1000.0)
+            << ";\n";
+    }
+    if (mapping.kind == NativeKind::NOISE && mapping.own_seed) {
+        out << "constexpr uint64_t kKey" << k << " = " << NativeRandomKey(mapping) << "ULL;\n";
+    }
+}
+
+// Per-node state members of the generated class
+void EmitNodeState(std::ostream& out, const NativeGraphSpec& spec, size_t k) {
+    const auto& mapping = spec.nodes[k].mapping;
+    const std::string n = std::to_string(k);
+    if (IsFilterKind(mapping.kind) && mapping.kind != NativeKind::SUSTAINED_CONDITION) {
+        out << "    double next_sample" << n << "_ = fixture_native::kNever;\n";
+    }
+    switch (mapping.kind) {
+        case NativeKind::DELAYED:
+            out << "    fixture_native::DelayedState state" << n << "_;\n";
+            break;
+        case NativeKind::LOWPASS:
+            out << "    bool primed" << n << "_ = false;\n";
+            break;
+        case NativeKind::MOVING_AVERAGE:
+            out << "    std::array<double, " << static_cast<uint32_t>(mapping.param("window", 1.0)) << "> ring" << n
+                << "_{};\n"
+                << "    uint32_t head" << n << "_ = 0;\n"
+                << "    uint32_t count" << n << "_ = 0;\n"
+                << "    double sum" << n << "_ = 0.0;\n";
+            break;
+        case NativeKind::DERIVATIVE:
+            out << "    double prev_x" << n << "_ = 0.0;\n"
+                << "    double prev_t" << n << "_ = 0.0;\n"
+                << "    bool primed" << n << "_ = false;\n";
+            break;
+        case NativeKind::NOISE:
+            if (!mapping.own_seed) {
+                out << "    const uint64_t key" << n << "_;\n";
+            }
+            out << "    uint64_t counter" << n << "_ = 0;\n";
+            break;
+        case NativeKind::SUSTAINED_CONDITION:
+            out << "    double since" << n << "_ = -1.0;\n";
+            break;
+        default:
+            break;
+    }
+}
+
+// One program per independent part of the fixture, matching what the runner builds
+void EmitProgram(std::ostream& out, size_t part, const FixtureConfig& config, const NativeGraphSpec& spec) {
+    const size_t inputs = spec.inputs.size();
+
+    out << "namespace part" << part << " {\n\n"
+        << "// Part: " << config.name << "\n\n"
+        << "constexpr uint64_t kFingerprint = " << spec.fingerprint() << "ULL;\n"
+        << "constexpr size_t kSlots = " << spec.slot_count() << ";\n\n";
+
+    out << "// Input slots\n";
+    for (size_t i = 0; i < inputs; ++i) {
+        out << "//   [" << i << "] " << spec.inputs[i] << "\n";
+    }
+    out << "\n";
+
+    for (size_t k = 0; k < spec.nodes.size(); ++k) {
+        EmitNodeConstants(out, spec, k);
+    }
+
+    // Random streams following the fixture's seed are keyed at create()
+    std::string keys;
+    for (size_t k = 0; k < spec.nodes.size(); ++k) {
+        const auto& mapping = spec.nodes[k].mapping;
+        if (mapping.kind == NativeKind::NOISE && !mapping.own_seed) {
+            keys += std::string(keys.empty() ? "\n        : " : ",\n          ") + "key" + std::to_string(k) +
+                    "_(NativeRandomKey(" + CppString(mapping.signal) + ", seed))";
+        }
+    }
+
+    out << "\nclass GeneratedProgram final : public NativeProgram {\n"
+        << "public:\n"
+        << "    explicit GeneratedProgram(uint64_t seed)" << keys << " {\n"
+        << "        (void)seed;\n"
+        << "    }\n\n"
+        << "    void set_input(uint32_t slot, double value) override {\n"
+        << "        values_[slot] = value;\n"
+        << "        dirty_[slot] = true;\n"
+        << "    }\n\n"
+        << "    void evaluate(Clock::time_point now, std::vector<NativeOutput>& outputs) override {\n"
+        << "        const double now_s = fixture_native::seconds(now);\n"
+        << "        (void)now;\n"
+        << "        (void)now_s;\n";
+    for (size_t k = 0; k < spec.nodes.size(); ++k) {
+        EmitNode(out, spec, k);
+    }
+    out << "        dirty_.fill(false);\n"
+        << "    }\n\n"
+        << "    std::optional<Clock::time_point> next_deadline() const override {\n"
+        << "        std::optional<Clock::time_point> deadline;\n"
+        << "        auto consider = [&](Clock::time_point t) {\n"
+        << "            if (!deadline || t < *deadline) {\n"
+        << "                deadline = t;\n"
+        << "            }\n"
+        << "        };\n"
+        << "        (void)consider;\n";
+    for (size_t k = 0; k < spec.nodes.size(); ++k) {
+        const NativeKind kind = spec.nodes[k].mapping.kind;
+        if (kind == NativeKind::DELAYED) {
+            out << "        if (state" << k << "_.armed) {\n"
+                << "            consider(state" << k << "_.due);\n"
+                << "        }\n";
+        } else if (kind == NativeKind::SUSTAINED_CONDITION) {
+            out << "        if (since" << k << "_ >= 0.0 && values_[" << spec.node_slot(k) << "] == 0.0) {\n"
+                << "            consider(fixture_native::from_seconds(since" << k << "_ + kDuration" << k << "));\n"
+                << "        }\n";
+        } else if (IsFilterKind(kind)) {
+            out << "        if (next_sample" << k << "_ != fixture_native::kNever) {\n"
+                << "            consider(fixture_native::from_seconds(next_sample" << k << "_));\n"
+                << "        }\n";
+        }
+    }
+    out << "        return deadline;\n"
+        << "    }\n\n"
+        << "private:\n"
+        << "    void Produce(uint32_t node, std::vector<NativeOutput>& outputs) {\n"
+        << "        const size_t slot = " << inputs << " + node;\n"
+        << "        dirty_[slot] = true;\n"
+        << "        outputs.push_back(NativeOutput{node, values_[slot]});\n"
+        << "    }\n\n"
+        << "    std::array<double, kSlots> values_{};\n"
+        << "    std::array<bool, kSlots> dirty_{};\n";
+    for (size_t k = 0; k < spec.nodes.size(); ++k) {
+        EmitNodeState(out, spec, k);
+    }
+    out << "};\n\n"
+        << "std::unique_ptr<NativeProgram> Create(uint64_t seed) {\n"
+        << "    return std::make_unique<GeneratedProgram>(seed);\n"
+        << "}\n\n"
+        << "const CompiledNativeProgram kRegistration(" << CppString(config.name) << ", kFingerprint, &Create);\n\n"
+        << "}  // namespace part" << part << "\n\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    google::InitGoogleLogging(argv[0]);
+    FLAGS_logtostderr = 1;
+
+    std::string config_file;
+    std::string output_file;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--config" && i + 1 < argc) {
+            config_file = argv[++i];
+        } else if (arg == "--output" && i + 1 < argc) {
+            output_file = argv[++i];
+        }
+    }
+    if (config_file.empty() || output_file.empty()) {
+        std::cerr << "Usage: " << argv[0] << " --config fixture.yaml --output fixture.cpp\n";
+        return 2;
+    }
+
+    FixtureConfig config;
+    if (!LoadFixtureConfig(config_file, config)) {
+        return 1;
+    }
+    if (!config.mappings.empty()) {
+        for (const auto& [signal, mapping] : config.mappings) {
+            LOG(ERROR) << "Mapping " << signal << " is not native; fixture-codegen needs native transforms only";
+        }
+        return 1;
+    }
+
+    for (const auto& mapping : config.native_mappings) {
+        if (mapping.kind == NativeKind::PLUGIN) {
+            LOG(ERROR) << "Mapping " << mapping.signal << " uses a plugin; link its transform into "
+                       << "the fixture instead of compiling it with fixture-codegen";
+            return 1;
+        }
+        if (mapping.kind == NativeKind::PLAYBACK) {
+            LOG(ERROR) << "Mapping " << mapping.signal << " plays back a recorded file, which "
+                       << "fixture-codegen cannot compile";
+            return 1;
+        }
+    }
+
+    std::ostringstream code;
+    code << "// Generated by fixture-codegen from " << config_file << ". Do not edit.\n"
+         << "// Fixture: " << config.name << "\n\n"
+         << "#include <array>\n"
+         << "#include <chrono>\n"
+         << "#include <memory>\n"
+         << "#include \"native_graph.hpp\"\n\n"
+         << "namespace {\n\n"
+         << "using fixture_native::Clock;\n\n";
+
+    const auto parts = PartitionFixtureConfig(config);
+    size_t nodes = 0;
+    for (size_t i = 0; i < parts.size(); ++i) {
+        NativeGraphSpec spec;
+        if (auto error = BuildNativeGraphSpec(parts[i].native_mappings, parts[i].serves, spec)) {
+            LOG(ERROR) << "Invalid native mappings: " << *error;
+            return 1;
+        }
+        EmitProgram(code, i, parts[i], spec);
+        nodes += spec.nodes.size();
+    }
+    code << "}  // namespace\n";
+
+    std::ofstream out(output_file, std::ios::trunc);
+    out << code.str();
+    if (!out) {
+        LOG(ERROR) << "Cannot write " << output_file;
+        return 1;
+    }
+
+    LOG(INFO) << "Generated " << nodes << " native node(s) in " << parts.size() << " part(s) for fixture '"
+              << config.name << "' into " << output_file;
+    return 0;
+}
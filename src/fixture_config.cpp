@@ -0,0 +1,418 @@
+#include "fixture_config.hpp"
+
+#include <algorithm>
+#include <unordered_set>
+#include <sys/stat.h>
+#include <glog/logging.h>
+#include <yaml-cpp/yaml.h>
+#include "path_trie.hpp"
+
+using vssdag::SignalMapping;
+
+namespace {
+
+bool ParseAckMode(const std::string& name, AckMode& mode) {
+    if (name == "processed") {
+        mode = AckMode::PROCESSED;
+    } else if (name == "immediate") {
+        mode = AckMode::IMMEDIATE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Log |text| and hand it to the caller
+bool Fail(std::string* message, const std::string& text) {
+    LOG(ERROR) << text;
+    if (message) {
+        *message = text;
+    }
+    return false;
+}
+
+}  // namespace
+
+bool LoadFixtureConfig(const std::string& config_file, FixtureConfig& config, std::string* message) {
+    // Check if file exists and is a regular file
+    struct stat st;
+    if (stat(config_file.c_str(), &st) != 0) {
+        return Fail(message, "Config file does not exist: " + config_file);
+    }
+    if (S_ISDIR(st.st_mode)) {
+        return Fail(message, "Config path is a directory, not a file: " + config_file);
+    }
+
+    const size_t slash = config_file.rfind('/');
+    const std::string config_dir = slash == std::string::npos ? "." : config_file.substr(0, slash);
+
+    try {
+        YAML::Node root = YAML::LoadFile(config_file);
+
+        if (!root["fixture"]) {
+            return Fail(message, "No 'fixture' section in config");
+        }
+
+        const YAML::Node& fixture = root["fixture"];
+
+        // Parse fixture name
+        config.name = fixture["name"].as<std::string>("Unnamed Fixture");
+        config.broker = fixture["broker"].as<std::string>("");
+        config.seed = fixture["seed"].as<uint64_t>(0);
+
+        // Parse serves section
+        if (!fixture["serves"]) {
+            return Fail(message, "No 'serves' section in fixture config");
+        }
+
+        // Entries are a signal path, or a map with the path under 'signal'
+        AckMode default_ack = AckMode::PROCESSED;
+        if (fixture["ack"] && !ParseAckMode(fixture["ack"].as<std::string>(), default_ack)) {
+            return Fail(message, "Unknown ack mode '" + fixture["ack"].as<std::string>() + "'");
+        }
+        for (const auto& signal_node : fixture["serves"]) {
+            ActuatorOptions options;
+            options.ack = default_ack;
+            std::string signal_path;
+            if (signal_node.IsMap()) {
+                if (!signal_node["signal"]) {
+                    return Fail(message, "Served actuator entry without 'signal'");
+                }
+                signal_path = signal_node["signal"].as<std::string>();
+                if (signal_node["ack"] && !ParseAckMode(signal_node["ack"].as<std::string>(), options.ack)) {
+                    return Fail(message, "Unknown ack mode '" + signal_node["ack"].as<std::string>() +
+                                         "' for " + signal_path);
+                }
+                if (signal_node["max_age_ms"]) {
+                    const long long max_age_ms = signal_node["max_age_ms"].as<long long>();
+                    if (max_age_ms < 0) {
+                        return Fail(message, "max_age_ms must not be negative for " + signal_path);
+                    }
+                    options.max_age = std::chrono::milliseconds(max_age_ms);
+                }
+                if (signal_node["accept"]) {
+                    if (auto error = AcceptRules::Parse(signal_node["accept"], options.accept)) {
+                        return Fail(message, "Invalid accept rules for " + signal_path + ": " + *error);
+                    }
+                }
+            } else {
+                signal_path = signal_node.as<std::string>();
+            }
+            config.serves.push_back(signal_path);
+            config.actuators.push_back(options);
+        }
+
+        LOG(INFO) << "Fixture '" << config.name << "' will serve "
+                  << config.serves.size() << " actuator(s)";
+
+        // Parse mappings section (VssDAG format)
+        if (!fixture["mappings"]) {
+            return Fail(message, "No 'mappings' section in fixture config");
+        }
+
+        std::unordered_set<std::string> mapped_signals;
+        for (const auto& mapping_node : fixture["mappings"]) {
+            if (!mapping_node["signal"]) {
+                continue;
+            }
+
+            std::string signal_name = mapping_node["signal"].as<std::string>();
+            if (!mapped_signals.insert(signal_name).second) {
+                return Fail(message, "Signal " + signal_name + " is mapped more than once");
+            }
+            SignalMapping mapping;
+
+            // Parse datatype
+            if (mapping_node["datatype"]) {
+                std::string datatype_str = mapping_node["datatype"].as<std::string>();
+                auto datatype_opt = vss::types::value_type_from_string(datatype_str);
+                if (datatype_opt.has_value()) {
+                    mapping.datatype = *datatype_opt;
+                } else {
+                    LOG(WARNING) << "Unknown datatype '" << datatype_str << "' for signal " << signal_name;
+                    mapping.datatype = vss::types::ValueType::UNSPECIFIED;
+                }
+            } else {
+                mapping.datatype = vss::types::ValueType::UNSPECIFIED;
+            }
+
+            // Optional value published at startup, before any command
+            if (mapping_node["initial"]) {
+                const YAML::Node& initial = mapping_node["initial"];
+                switch (mapping.datatype) {
+                    case vss::types::ValueType::BOOL:
+                        config.initial[signal_name] = initial.as<bool>();
+                        break;
+                    case vss::types::ValueType::STRING:
+                        config.initial[signal_name] = initial.as<std::string>();
+                        break;
+                    case vss::types::ValueType::UNSPECIFIED:
+                        return Fail(message, "Initial value for " + signal_name + " needs a datatype");
+                    default:
+                        config.initial[signal_name] = VssValueFromNative(initial.as<double>(), mapping.datatype);
+                        break;
+                }
+            }
+
+            // Parse depends_on (keep original signal names)
+            if (mapping_node["depends_on"]) {
+                for (const auto& dep : mapping_node["depends_on"]) {
+                    std::string dep_signal = dep.as<std::string>();
+                    mapping.depends_on.push_back(dep_signal);
+                }
+            }
+
+            // Native and plugin transforms are evaluated in C++, outside the DAG
+            if (mapping_node["transform"] &&
+                (mapping_node["transform"]["native"] || mapping_node["transform"]["plugin"])) {
+                NativeMappingSpec native;
+                native.signal = signal_name;
+                native.datatype = mapping.datatype;
+                native.depends_on = mapping.depends_on;
+                if (auto error = ParseNativeTransform(mapping_node["transform"], config_dir, native)) {
+                    return Fail(message, "Invalid native mapping for " + signal_name + ": " + *error);
+                }
+                if (!native.own_seed) {
+                    native.seed = config.seed;
+                }
+                config.native_mappings.push_back(std::move(native));
+                continue;
+            }
+
+            // Parse delay (convert to interval_ms for DAG)
+            if (mapping_node["delay"]) {
+                double delay_seconds = mapping_node["delay"].as<double>();
+                mapping.interval_ms = static_cast<int>(delay_seconds * 1000);
+            }
+
+            // Parse transform code (keep original signal names)
+            if (mapping_node["transform"] && mapping_node["transform"]["code"]) {
+                std::string code = mapping_node["transform"]["code"].as<std::string>();
+                mapping.transform = vssdag::CodeTransform{.expression = code};
+            }
+
+            config.mappings[signal_name] = mapping;
+        }
+
+        LOG(INFO) << "Loaded " << config.mappings.size() << " signal mappings"
+                  << " (+" << config.native_mappings.size() << " native)";
+
+        // A served actuator's initial value is evaluated as if commanded, so it
+        // must be a command the actuator accepts
+        for (size_t i = 0; i < config.serves.size(); ++i) {
+            auto initial = config.initial.find(config.serves[i]);
+            if (initial == config.initial.end() || config.actuators[i].accept.empty()) {
+                continue;
+            }
+            AcceptRules rules = config.actuators[i].accept;  // check() records the command for max_rate
+            if (const char* reason = rules.check(initial->second, std::chrono::steady_clock::now())) {
+                return Fail(message, "Initial value for " + config.serves[i] + " fails its accept rules: " + reason);
+            }
+        }
+
+        config.precedence = fixture["precedence"].as<int>(config.precedence);
+        config.partitions = std::max<size_t>(1, fixture["partitions"].as<size_t>(config.partitions));
+        config.tick_hz = fixture["tick_hz"].as<double>(config.tick_hz);
+        if (!(config.tick_hz >= 0)) {
+            return Fail(message, "tick_hz must not be negative");
+        }
+
+        // Fleet mode: copies told apart by a path prefix or broker per replica
+        config.replicas = std::max<size_t>(1, fixture["replicas"].as<size_t>(config.replicas));
+        if (fixture["replica"]) {
+            config.replica_prefix = fixture["replica"]["prefix"].as<std::string>("");
+            config.replica_broker = fixture["replica"]["broker"].as<std::string>("");
+        }
+        if (config.replicas > 1 && config.replica_prefix.find("{n}") == std::string::npos &&
+            config.replica_broker.find("{n}") == std::string::npos) {
+            return Fail(message, "Fixture '" + config.name + "' has " + std::to_string(config.replicas) +
+                                     " replicas but neither replica.prefix nor replica.broker contains {n}");
+        }
+
+        // Parse optional batching budget for the DAG owner thread
+        if (fixture["batching"]) {
+            const YAML::Node& batching = fixture["batching"];
+            auto& options = config.batching;
+            options.immediate_depth = batching["immediate_depth"].as<size_t>(options.immediate_depth);
+            options.max_batch = std::max<size_t>(1, batching["max_batch"].as<size_t>(options.max_batch));
+            options.max_wait = std::chrono::microseconds(
+                batching["max_wait_us"].as<long long>(options.max_wait.count()));
+            config.max_queued = std::max<size_t>(1, batching["max_queued"].as<size_t>(config.max_queued));
+        }
+
+    } catch (const YAML::Exception& e) {
+        return Fail(message, std::string("Failed to parse YAML config: ") + e.what());
+    }
+    return true;
+}
+
+std::unordered_map<std::string, SignalMapping> BuildDagMappings(const FixtureConfig& config) {
+    const PathTrie served(config.serves);
+    std::unordered_map<std::string, SignalMapping> dag_mappings;
+
+    // Transform user mappings: add .target suffix for served actuators
+    for (const auto& [signal_name, mapping] : config.mappings) {
+        SignalMapping dag_mapping = mapping;
+
+        // Transform depends_on: add .target to served actuators
+        dag_mapping.depends_on.clear();
+        for (const auto& dep : mapping.depends_on) {
+            if (served.contains(dep)) {
+                dag_mapping.depends_on.push_back(dep + ".target");
+            } else {
+                dag_mapping.depends_on.push_back(dep);
+            }
+        }
+
+        // Transform code: replace served actuator references with .target
+        if (std::holds_alternative<vssdag::CodeTransform>(mapping.transform)) {
+            std::string code = std::get<vssdag::CodeTransform>(mapping.transform).expression;
+
+            for (const auto& actuator : config.serves) {
+                // Find and replace: deps["actuator"] -> deps["actuator.target"]
+                std::string search = "deps[\"" + actuator + "\"]";
+                std::string replace = "deps[\"" + actuator + ".target\"]";
+                size_t pos = 0;
+                while ((pos = code.find(search, pos)) != std::string::npos) {
+                    code.replace(pos, search.length(), replace);
+                    pos += replace.length();
+                }
+                // Also handle single quotes: deps['actuator']
+                search = "deps['" + actuator + "']";
+                replace = "deps['" + actuator + ".target']";
+                pos = 0;
+                while ((pos = code.find(search, pos)) != std::string::npos) {
+                    code.replace(pos, search.length(), replace);
+                    pos += replace.length();
+                }
+            }
+
+            dag_mapping.transform = vssdag::CodeTransform{.expression = code};
+        }
+
+        dag_mappings[signal_name] = dag_mapping;
+    }
+
+    // Add .target signals as source signals (external inputs)
+    for (const auto& actuator : config.serves) {
+        std::string target_signal = actuator + ".target";
+        if (dag_mappings.find(target_signal) == dag_mappings.end()) {
+            SignalMapping target_mapping;
+            target_mapping.datatype = vss::types::ValueType::UNSPECIFIED;
+            // Mark as input signal by setting source
+            target_mapping.source = vssdag::SignalSource{"actuator", target_signal};
+            // No depends_on = external input signal
+            dag_mappings[target_signal] = target_mapping;
+        }
+    }
+
+    return dag_mappings;
+}
+
+void SetFixtureSeed(FixtureConfig& config, uint64_t seed) {
+    config.seed = seed;
+    for (auto& native : config.native_mappings) {
+        if (!native.own_seed) {
+            native.seed = seed;
+        }
+    }
+}
+
+std::string ReplicaString(const std::string& pattern, size_t replica) {
+    const std::string index = std::to_string(replica);
+    std::string result = pattern;
+    size_t pos = 0;
+    while ((pos = result.find("{n}", pos)) != std::string::npos) {
+        result.replace(pos, 3, index);
+        pos += index.size();
+    }
+    return result;
+}
+
+uint64_t ReplicaSeed(uint64_t seed, size_t replica) {
+    return replica == 0 ? seed : fixture_native::mix64(seed ^ fixture_native::mix64(replica));
+}
+
+std::vector<FixtureConfig> PartitionFixtureConfig(const FixtureConfig& config) {
+    const size_t max_parts = config.partitions;
+    if (max_parts < 2) {
+        return {config};
+    }
+
+    // Union-find over signal paths
+    std::unordered_map<std::string, size_t> ids;
+    std::vector<size_t> parent;
+    auto id = [&](const std::string& signal) {
+        auto [it, inserted] = ids.emplace(signal, parent.size());
+        if (inserted) {
+            parent.push_back(parent.size());
+        }
+        return it->second;
+    };
+    auto find = [&](size_t x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    };
+    auto unite = [&](const std::string& a, const std::string& b) {
+        parent[find(id(a))] = find(id(b));
+    };
+
+    for (const auto& actuator : config.serves) {
+        id(actuator);
+    }
+    for (const auto& native : config.native_mappings) {
+        id(native.signal);
+        for (const auto& dep : native.depends_on) {
+            unite(native.signal, dep);
+        }
+    }
+    for (const auto& [signal, mapping] : config.mappings) {
+        id(signal);
+        for (const auto& dep : mapping.depends_on) {
+            unite(signal, dep);
+        }
+    }
+
+    FixtureConfig empty = config;
+    empty.serves.clear();
+    empty.actuators.clear();
+    empty.mappings.clear();
+    empty.native_mappings.clear();
+    empty.initial.clear();
+
+    std::vector<FixtureConfig> parts;
+    std::unordered_map<size_t, size_t> part_of_root;
+    size_t components = 0;
+    auto part_for = [&](const std::string& signal) -> FixtureConfig& {
+        auto [it, inserted] = part_of_root.emplace(find(id(signal)), components % max_parts);
+        if (inserted && ++components <= max_parts) {
+            parts.push_back(empty);
+        }
+        return parts[it->second];
+    };
+
+    for (size_t i = 0; i < config.serves.size(); ++i) {
+        FixtureConfig& part = part_for(config.serves[i]);
+        part.serves.push_back(config.serves[i]);
+        part.actuators.push_back(config.actuators[i]);
+    }
+    for (const auto& native : config.native_mappings) {
+        part_for(native.signal).native_mappings.push_back(native);
+    }
+    for (const auto& [signal, mapping] : config.mappings) {
+        part_for(signal).mappings.emplace(signal, mapping);
+    }
+    for (const auto& [signal, value] : config.initial) {
+        part_for(signal).initial.emplace(signal, value);
+    }
+
+    if (parts.size() > 1) {
+        for (size_t i = 0; i < parts.size(); ++i) {
+            parts[i].name = config.name + " #" + std::to_string(i + 1);
+        }
+    }
+    return parts.empty() ? std::vector<FixtureConfig>{config} : parts;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <vssdag/mapping_types.h>
+#include "accept_rules.hpp"
+#include "batch_window.hpp"
+#include "native_graph.hpp"
+
+// When the serve_actuator callback returns, acknowledging the command
+enum class AckMode {
+    PROCESSED,  // After the resulting outputs have been published
+    IMMEDIATE,  // As soon as the command is queued for the DAG owner
+};
+
+// Per served actuator settings
+struct ActuatorOptions {
+    AckMode ack = AckMode::PROCESSED;
+    AcceptRules accept;  // Commands failing these never reach the mappings
+    std::chrono::milliseconds max_age{0};  // Stale without a command for this long; 0 = never
+};
+
+struct FixtureConfig {
+    std::string name;
+    std::string broker;  // Databroker address; empty to use --kuksa
+    uint64_t seed = 0;   // Random streams of mappings without their own seed
+    std::vector<std::string> serves;  // Actuators to register
+    std::vector<ActuatorOptions> actuators;  // Parallel to serves
+    std::unordered_map<std::string, vssdag::SignalMapping> mappings;  // DAG mappings (Lua)
+    std::vector<NativeMappingSpec> native_mappings;  // Native mappings, in YAML order
+    std::unordered_map<std::string, vss::types::Value> initial;  // Mapped signal -> value at startup
+    AdaptiveBatchWindow::Options batching;  // DAG owner batching budget
+    size_t max_queued = 4096;  // Ingress bound; immediately acked commands wait for room
+    int precedence = 0;        // Wins paths shared with other fixtures over lower values
+    size_t partitions = 1;     // Most workers for independent subgraphs; 1 (default) evaluates one graph
+    double tick_hz = 10;       // Time-based passes of the Lua mappings; 0 never
+    size_t replicas = 1;          // Copies of the fixture served side by side
+    std::string replica_prefix;   // Before every path of a replica; {n} is its index
+    std::string replica_broker;   // Broker of a replica, {n} is its index; empty to use broker
+};
+
+/**
+ * @brief Load a fixture YAML file into |config|
+ *
+ * Problems are logged; parsing stops at the first fatal one, whose message
+ * is also stored in |message| if given.
+ *
+ * @return true if the whole file was loaded
+ */
+bool LoadFixtureConfig(const std::string& config_file, FixtureConfig& config, std::string* message = nullptr);
+
+/**
+ * @brief Lua mappings of |config| as the DAG evaluates them
+ *
+ * Served actuators are both commanded and published, so the DAG reads their
+ * commands as "<path>.target": dependencies on served actuators, in
+ * depends_on and in deps['<path>'] lookups, are renamed, and each
+ * "<path>.target" is added as an external input.
+ */
+std::unordered_map<std::string, vssdag::SignalMapping> BuildDagMappings(const FixtureConfig& config);
+
+// Reseed |config| and the mappings that follow the fixture's seed
+void SetFixtureSeed(FixtureConfig& config, uint64_t seed);
+
+// |pattern| with each {n} replaced by |replica|
+std::string ReplicaString(const std::string& pattern, size_t replica);
+
+// Seed of replica |replica| of a fixture seeded |seed|: replica 0 keeps it,
+// the others draw streams of their own
+uint64_t ReplicaSeed(uint64_t seed, size_t replica);
+
+/**
+ * @brief Split |config| into its independent parts
+ *
+ * Served actuators and mappings are connected through depends_on; each
+ * connected component becomes one config with the fixture's other settings,
+ * named "<name> #<n>" when there is more than one. Components beyond
+ * config.partitions are folded round-robin into the first ones, so runner and
+ * fixture-codegen always agree on the parts.
+ *
+ * @return |config| alone if it is connected or partitioning is disabled
+ */
+std::vector<FixtureConfig> PartitionFixtureConfig(const FixtureConfig& config);
@@ -0,0 +1,378 @@
+/**
+ * fixture-diff - compare two capture files
+ *
+ * Compares the outputs recorded with `fixture-runner --capture` by two runs,
+ * for example before and after a runner or libvssdag upgrade. Points of a
+ * signal are paired by time: a pair within the timing tolerance is a match
+ * and its values are compared with the value tolerance; a point with no
+ * partner is a timing divergence. Times are relative to the start of each
+ * recording unless --absolute is given.
+ *
+ * Both files are read chunk by chunk in step with each other, so memory use
+ * depends on the publish rate, not on the length of the recordings, nor on
+ * signals that are missing or sparse in one of them.
+ *
+ * Exit status: 0 if equivalent, 1 if they diverge, 2 on usage or read errors.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <glog/logging.h>
+#include "capture.hpp"
+#include "gorilla.hpp"
+
+namespace {
+
+constexpr int64_t kNever = std::numeric_limits<int64_t>::min() / 4;
+constexpr int64_t kForever = std::numeric_limits<int64_t>::max() / 4;
+
+// How far a point may trail a later point of another signal in file order
+constexpr int64_t kReorderUs =
+    2 * std::chrono::duration_cast<std::chrono::microseconds>(capture::kFlushInterval).count();
+
+struct Point {
+    int64_t t;  // Microseconds, relative unless --absolute
+    double value;
+};
+
+struct SignalDiff {
+    std::deque<Point> pending[2];
+    int64_t last[2] = {kNever, kNever};  // Latest point read from each file
+    uint64_t matched = 0;
+    uint64_t value_mismatches = 0;
+    uint64_t only[2] = {0, 0};
+    double max_value_diff = 0.0;
+    int64_t max_skew_us = 0;
+    std::optional<int64_t> first_divergence_us;
+    std::string first_divergence;
+};
+
+struct Options {
+    double tolerance = 0.0;
+    std::map<std::string, double> signal_tolerance;
+    int64_t time_tolerance_us = 50'000;
+    bool absolute = false;
+};
+
+class Side {
+public:
+    explicit Side(const std::string& path) : path_(path), reader_(path) {}
+
+    bool Open(bool absolute) {
+        if (!reader_.error().empty()) {
+            std::cerr << reader_.error() << "\n";
+            return false;
+        }
+        if (!absolute) {
+            origin_ = reader_.start_timestamp().value_or(0);
+        }
+        return true;
+    }
+
+    // Read the next chunk, decoded into |points|; false at the end
+    bool Read(std::string& signal, std::vector<Point>& points) {
+        if (done_) {
+            return false;
+        }
+        if (!reader_.next(chunk_)) {
+            done_ = true;
+            if (!reader_.error().empty()) {
+                std::cerr << reader_.error() << "\n";
+                failed_ = true;
+            }
+            return false;
+        }
+        signal = *chunk_.signal;
+        points.clear();
+        GorillaDecoder decoder(chunk_.bytes.data(), chunk_.bytes.size(), chunk_.count);
+        int64_t t;
+        double value;
+        while (decoder.next(t, value)) {
+            points.push_back(Point{t - origin_, value});
+        }
+        if (points.size() != chunk_.count) {
+            std::cerr << path_ << ": damaged chunk for " << signal << "\n";
+            failed_ = true;
+        }
+        frontier_ = std::max(frontier_, chunk_.first_timestamp_us - origin_);
+        if (!points.empty()) {
+            latest_ = std::max(latest_, points.back().t);
+        }
+        return true;
+    }
+
+    int64_t frontier() const { return done_ ? kForever : frontier_; }
+
+    // No point earlier than this is still to come from the file, whatever
+    // its signal
+    int64_t watermark() const { return done_ ? kForever : latest_ - kReorderUs; }
+    bool done() const { return done_; }
+    bool failed() const { return failed_; }
+    const std::map<std::string, uint64_t>& seeds() const { return reader_.seeds(); }
+
+private:
+    std::string path_;
+    CaptureReader reader_;
+    CaptureReader::Chunk chunk_;
+    int64_t origin_ = 0;
+    int64_t frontier_ = kNever;
+    int64_t latest_ = kNever;  // Latest point read, of any signal
+    bool done_ = false;
+    bool failed_ = false;
+};
+
+std::string FormatSeconds(int64_t us) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.6fs", static_cast<double>(us) / 1e6);
+    return buf;
+}
+
+std::string FormatValue(double value) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.17g", value);
+    return buf;
+}
+
+bool ValuesMatch(double a, double b, double tolerance) {
+    if (std::isnan(a) || std::isnan(b)) {
+        return std::isnan(a) && std::isnan(b);
+    }
+    return a == b || std::fabs(a - b) <= tolerance;
+}
+
+void NoteDivergence(SignalDiff& diff, int64_t t, const std::string& what) {
+    if (!diff.first_divergence_us || t < *diff.first_divergence_us) {
+        diff.first_divergence_us = t;
+        diff.first_divergence = what;
+    }
+}
+
+// Whether the point after the front of |points| is nearer to |t| than |skew|,
+// or nullopt while that point may still be read (see Resolve)
+std::optional<bool> NextIsCloser(const std::deque<Point>& points, int64_t t, int64_t skew, int64_t watermark) {
+    if (points.size() > 1) {
+        const int64_t next = points[1].t > t ? points[1].t - t : t - points[1].t;
+        return next < skew;
+    }
+    if (skew > 0 && watermark < t + skew) {
+        return std::nullopt;
+    }
+    return false;
+}
+
+// Pair up pending points that can no longer gain a partner from a later read.
+// Chunks of one signal are in time order, so nothing earlier than the latest
+// point of the signal read from a file is still to come from it; nor is
+// anything earlier than the file's watermark, which moves on even for a
+// signal the file has few or no points of.
+//
+// Fronts within the window pair up unless the next point of one side is
+// closer to the other front: with first {0, 40ms} and second {40ms}, 40 pairs
+// with 40 and 0 is only in the first capture.
+void Resolve(SignalDiff& diff, double tolerance, const Options& options, const int64_t file_watermark[2]) {
+    const int64_t watermark[2] = {std::max(diff.last[0], file_watermark[0]),
+                                  std::max(diff.last[1], file_watermark[1])};
+    auto& a = diff.pending[0];
+    auto& b = diff.pending[1];
+    const int64_t window = options.time_tolerance_us;
+    while (true) {
+        if (!a.empty() && !b.empty()) {
+            const Point pa = a.front();
+            const Point pb = b.front();
+            const int64_t skew = pa.t > pb.t ? pa.t - pb.t : pb.t - pa.t;
+            if (skew <= window) {
+                const std::optional<bool> a_next = NextIsCloser(a, pb.t, skew, watermark[0]);
+                const std::optional<bool> b_next = NextIsCloser(b, pa.t, skew, watermark[1]);
+                if (a_next.value_or(false)) {
+                    ++diff.only[0];
+                    NoteDivergence(diff, pa.t, "only in first capture");
+                    a.pop_front();
+                    continue;
+                }
+                if (b_next.value_or(false)) {
+                    ++diff.only[1];
+                    NoteDivergence(diff, pb.t, "only in second capture");
+                    b.pop_front();
+                    continue;
+                }
+                if (!a_next || !b_next) {
+                    break;
+                }
+                ++diff.matched;
+                diff.max_skew_us = std::max(diff.max_skew_us, skew);
+                if (!ValuesMatch(pa.value, pb.value, tolerance)) {
+                    ++diff.value_mismatches;
+                    diff.max_value_diff = std::max(diff.max_value_diff, std::fabs(pa.value - pb.value));
+                    NoteDivergence(diff, pa.t, "value " + FormatValue(pa.value) + " vs " + FormatValue(pb.value));
+                }
+                a.pop_front();
+                b.pop_front();
+            } else if (pa.t < pb.t) {
+                ++diff.only[0];
+                NoteDivergence(diff, pa.t, "only in first capture");
+                a.pop_front();
+            } else {
+                ++diff.only[1];
+                NoteDivergence(diff, pb.t, "only in second capture");
+                b.pop_front();
+            }
+        } else if (!a.empty() && a.front().t + window < watermark[1]) {
+            ++diff.only[0];
+            NoteDivergence(diff, a.front().t, "only in first capture");
+            a.pop_front();
+        } else if (!b.empty() && b.front().t + window < watermark[0]) {
+            ++diff.only[1];
+            NoteDivergence(diff, b.front().t, "only in second capture");
+            b.pop_front();
+        } else {
+            break;
+        }
+    }
+}
+
+double ToleranceFor(const Options& options, const std::string& signal) {
+    auto it = options.signal_tolerance.find(signal);
+    return it != options.signal_tolerance.end() ? it->second : options.tolerance;
+}
+
+// The whole of |text| as a number of at least 0
+bool ParseNonNegative(const std::string& text, double& value) {
+    try {
+        size_t used = 0;
+        value = std::stod(text, &used);
+        return used == text.size() && value >= 0.0;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+void PrintUsage(const char* program) {
+    std::cerr << "Usage: " << program << " FIRST.fxcap SECOND.fxcap [options]\n"
+              << "  --tolerance V              absolute value tolerance (0)\n"
+              << "  --tolerance SIGNAL=V       value tolerance for one signal\n"
+              << "  --time-tolerance-ms N      pairing window for timestamps (50)\n"
+              << "  --absolute                 compare wall-clock times instead of times since start\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    google::InitGoogleLogging(argv[0]);
+    FLAGS_logtostderr = 1;
+
+    Options options;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--tolerance" && i + 1 < argc) {
+            const std::string value = argv[++i];
+            const size_t eq = value.rfind('=');
+            double tolerance;
+            if (!ParseNonNegative(eq == std::string::npos ? value : value.substr(eq + 1), tolerance)) {
+                std::cerr << "Invalid tolerance: " << value << "\n";
+                return 2;
+            }
+            if (eq == std::string::npos) {
+                options.tolerance = tolerance;
+            } else {
+                options.signal_tolerance[value.substr(0, eq)] = tolerance;
+            }
+        } else if (arg == "--time-tolerance-ms" && i + 1 < argc) {
+            const std::string value = argv[++i];
+            double ms;
+            if (!ParseNonNegative(value, ms) || ms * 1000.0 >= static_cast<double>(kForever)) {
+                std::cerr << "Invalid time tolerance: " << value << "\n";
+                return 2;
+            }
+            options.time_tolerance_us = static_cast<int64_t>(ms * 1000.0);
+        } else if (arg == "--absolute") {
+            options.absolute = true;
+        } else if (!arg.empty() && arg[0] != '-') {
+            files.push_back(arg);
+        } else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (files.size() != 2) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    Side sides[2] = {Side(files[0]), Side(files[1])};
+    if (!sides[0].Open(options.absolute) || !sides[1].Open(options.absolute)) {
+        return 2;
+    }
+
+    std::map<std::string, SignalDiff> signals;
+    std::string signal;
+    std::vector<Point> points;
+    uint64_t chunks = 0;
+
+    // Always advance the file that is further behind, so both stay in step
+    while (!sides[0].done() || !sides[1].done()) {
+        const int side = sides[0].frontier() <= sides[1].frontier() ? 0 : 1;
+        if (!sides[side].Read(signal, points)) {
+            continue;
+        }
+        SignalDiff& diff = signals[signal];
+        diff.pending[side].insert(diff.pending[side].end(), points.begin(), points.end());
+        if (!points.empty()) {
+            diff.last[side] = std::max(diff.last[side], points.back().t);
+        }
+
+        // Every signal's points resolve as the files move on, including those
+        // the other file has none of; sweeping all signals now and then keeps
+        // those from piling up
+        const int64_t watermark[2] = {sides[0].watermark(), sides[1].watermark()};
+        Resolve(diff, ToleranceFor(options, signal), options, watermark);
+        if (++chunks % 1024 == 0) {
+            for (auto& [name, other] : signals) {
+                Resolve(other, ToleranceFor(options, name), options, watermark);
+            }
+        }
+    }
+
+    const int64_t end[2] = {kForever, kForever};
+    uint64_t matched = 0;
+    uint64_t diverging = 0;
+    for (auto& [name, diff] : signals) {
+        Resolve(diff, ToleranceFor(options, name), options, end);
+        matched += diff.matched;
+        if (!diff.first_divergence_us) {
+            continue;
+        }
+        ++diverging;
+        std::cout << name << ":\n"
+                  << "  matched " << diff.matched << ", value mismatches " << diff.value_mismatches
+                  << " (max diff " << diff.max_value_diff << ")\n"
+                  << "  only in first " << diff.only[0] << ", only in second " << diff.only[1]
+                  << ", max skew " << FormatSeconds(diff.max_skew_us) << "\n"
+                  << "  first divergence at " << FormatSeconds(*diff.first_divergence_us) << ": "
+                  << diff.first_divergence << "\n";
+    }
+
+    // Random outputs of fixtures run with different seeds are bound to differ
+    for (const auto& [fixture, seed] : sides[0].seeds()) {
+        auto other = sides[1].seeds().find(fixture);
+        if (other != sides[1].seeds().end() && other->second != seed) {
+            std::cout << "note: fixture '" << fixture << "' ran with seed " << seed << " in the first capture and "
+                      << other->second << " in the second\n";
+        }
+    }
+
+    std::cout << signals.size() << " signal(s), " << matched << " matched point(s), " << diverging
+              << " diverging signal(s)\n";
+    if (sides[0].failed() || sides[1].failed()) {
+        return 2;
+    }
+    return diverging == 0 ? 0 : 1;
+}
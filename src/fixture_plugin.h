@@ -0,0 +1,88 @@
+/**
+ * Fixture plugin ABI
+ *
+ * Native transform functions loaded with dlopen() from a fixture mapping:
+ *
+ *   transform:
+ *     plugin: "libmotor.so"
+ *     fn: "window_motor"
+ *     params: {speed: 0.25}
+ *
+ * The library exports, for each transform name <fn>:
+ *
+ *   uint32_t fixture_plugin_abi_version(void);              (once per library)
+ *   int      <fn>(fixture_call* call);                        (required)
+ *   void*    <fn>_create(const fixture_param*, size_t);       (optional)
+ *   void     <fn>_destroy(void* state);                       (optional)
+ *
+ * <fn> is called when any dependency changes and when the time it asked for
+ * in next_call_s has come. It returns FIXTURE_OUTPUT when it wrote *output,
+ * FIXTURE_NO_OUTPUT to publish nothing, or a negative value on error.
+ *
+ * This header is plain C and only ever extended by appending fields to the
+ * end of structs together with a bump of FIXTURE_PLUGIN_ABI_VERSION.
+ */
+
+#ifndef FIXTURE_PLUGIN_H
+#define FIXTURE_PLUGIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FIXTURE_PLUGIN_ABI_VERSION 1u
+
+#define FIXTURE_NO_OUTPUT 0
+#define FIXTURE_OUTPUT 1
+
+typedef enum fixture_type {
+    FIXTURE_TYPE_BOOL = 1,
+    FIXTURE_TYPE_INT64 = 2,
+    FIXTURE_TYPE_UINT64 = 3,
+    FIXTURE_TYPE_DOUBLE = 4
+} fixture_type;
+
+typedef struct fixture_value {
+    fixture_type type;
+    union {
+        uint8_t b;
+        int64_t i64;
+        uint64_t u64;
+        double f64;
+    } as;
+} fixture_value;
+
+typedef struct fixture_param {
+    const char* key;
+    double value;
+} fixture_param;
+
+typedef struct fixture_call {
+    uint32_t abi_version;
+
+    /* One value per depends_on entry, in YAML order */
+    const fixture_value* inputs;
+    const uint8_t* changed;      /* Non-zero where the input changed since the last call */
+    size_t input_count;
+
+    /* Type preset from the mapping datatype; the plugin fills in the value */
+    fixture_value* output;
+
+    double now_s;                /* Monotonic time in seconds */
+    double next_call_s;          /* Set to request a call at that time; 0 = only on input change */
+    void* state;                 /* Returned by <fn>_create, or NULL */
+} fixture_call;
+
+typedef uint32_t (*fixture_abi_version_fn)(void);
+typedef int (*fixture_transform_fn)(fixture_call* call);
+typedef void* (*fixture_create_fn)(const fixture_param* params, size_t param_count);
+typedef void (*fixture_destroy_fn)(void* state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FIXTURE_PLUGIN_H */
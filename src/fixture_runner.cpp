@@ -3,19 +3,27 @@
  *
  * Simulates hardware responses to actuator commands using VssDAG for computation.
  * Claims ownership of actuators (serves) and uses DAG to calculate effect values.
+ * Mappings with native transforms are evaluated in C++ ahead of the DAG.
  */
 
+#include <csignal>
+#include <cstdlib>
 #include <iostream>
 #include <string>
 #include <thread>
 #include <chrono>
 #include <map>
 #include <memory>
+#include <optional>
+#include <sstream>
 #include <vector>
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include <algorithm>
-#include <yaml-cpp/yaml.h>
-#include <fstream>
-#include <sys/stat.h>
+#include <unordered_map>
+#include <unordered_set>
 #include <glog/logging.h>
 #include <kuksa_cpp/kuksa.hpp>
 #include <vssdag/signal_processor.h>
@@ -23,85 +31,156 @@
 #include <vssdag/signal_source_info.h>
 #include <vss/types/value.hpp>
 #include <vss/types/quality.hpp>
+#include "batch_window.hpp"
+#include "broker_pool.hpp"
+#include "capture.hpp"
+#include "fixture_config.hpp"
+#include "metrics.hpp"
+#include "native_graph.hpp"
+#include "output_dispatcher.hpp"
+#include "output_merge.hpp"
+#include "path_trie.hpp"
+#include "startup_report.hpp"
+#include "timing_wheel.hpp"
+#include "worker_pool.hpp"
 
 using namespace kuksa;
 using namespace vssdag;
 
-struct FixtureConfig {
-    std::string name;
-    std::vector<std::string> serves;  // Actuators to register
-    std::unordered_map<std::string, SignalMapping> mappings;  // DAG mappings
+using QualifiedOutput = decltype(vssdag::VSSSignal::qualified_value);
+
+// Actuation waiting in the ingress queue for the DAG owner thread
+struct PendingActuation {
+    uint64_t seq;
+    size_t actuator;  // Index into FixtureConfig::serves
+    vss::types::Value value;
+    std::chrono::steady_clock::time_point received;
 };
 
-class FixtureRunner {
+// Qualified value for outputs computed outside the DAG
+QualifiedOutput MakeQualifiedOutput(vss::types::Value value, vss::types::SignalQuality quality) {
+    QualifiedOutput qualified;
+    qualified.value = std::move(value);
+    qualified.quality = quality;
+    qualified.timestamp = std::chrono::system_clock::now();
+    return qualified;
+}
+
+class FixtureRunner : public WorkerPool::Task {
 private:
-    std::unique_ptr<Resolver> resolver_;
+    // Connection shared with other fixtures routed to the same broker
+    BrokerPool& brokers_;
+    BrokerPool::Connection* connection_ = nullptr;
+    Resolver* resolver_ = nullptr;
     std::shared_ptr<Client> client_;
-    std::string kuksa_address_;
+    std::string kuksa_address_;  // --kuksa, unless the fixture names its own broker
+    std::string path_prefix_;    // Before every path on the broker; replicas only
     FixtureConfig config_;
     std::unique_ptr<SignalProcessorDAG> dag_processor_;
-    bool running_ = false;
-
-    // Map signal paths to resolved handles for faster publishing
-    std::unordered_map<std::string, std::shared_ptr<DynamicSignalHandle>> signal_handles_;
-
-    // Transform mappings for VssDAG: add .target suffix to served actuators
+    std::atomic<bool> running_{false};
+
+    // Map signal paths to resolved handles and publish channels
+    std::unordered_map<std::string, OutputTarget> signal_handles_;
+
+    // Per served actuator (parallel to config_.serves)
+    PathTrie served_;                          // Path -> index into config_.serves
+    std::vector<std::string> target_signals_;  // "<path>.target" DAG input name
+    std::vector<int> native_slots_;            // Native input slot, -1 if unused
+
+    // Native mappings: evaluated before the DAG, outputs optionally fed into it
+    NativeGraphSpec native_spec_;
+    std::unique_ptr<NativeProgram> native_program_;
+    std::vector<NativeOutput> native_outputs_;
+    std::vector<bool> native_feeds_dag_;  // Per native node
+    std::unordered_set<std::string> native_signals_;
+    bool has_dag_mappings_ = false;
+
+    // Staleness watchdog: a served actuator with a max_age goes stale when its
+    // commands stop, and everything reading it sees NOT_AVAILABLE until the
+    // next command. Touched only by the DAG owner thread.
+    TimingWheel watchdog_;
+    std::vector<std::chrono::steady_clock::time_point> last_command_;  // Per served actuator
+    std::vector<uint8_t> watched_;                                     // Per served actuator
+    std::vector<uint8_t> stale_;                                       // Per served actuator
+    std::vector<std::vector<uint32_t>> native_downstream_;  // Per served actuator: native nodes reading it
+    std::vector<uint32_t> native_stale_inputs_;             // Per native node
+    std::vector<std::optional<double>> native_last_;        // Per native node: last value computed
+    std::vector<uint64_t> native_emitted_pass_;             // Per native node
+    uint64_t pass_ = 0;
+    std::vector<uint32_t> expired_;
+
+    // Splitting a batch into passes: the pass each actuator was last commanded in
+    std::vector<uint64_t> batch_pass_of_;  // Per served actuator
+    uint64_t batch_pass_ = 0;
+
+    // Ingress queue: actuator callbacks enqueue, the DAG owner thread (Run) drains.
+    // SignalProcessorDAG is only ever touched from the DAG owner thread.
+    std::mutex ingress_mutex_;
+    std::condition_variable ingress_cv_;
+    std::condition_variable processed_cv_;
+    std::deque<PendingActuation> ingress_;
+    uint64_t enqueued_seq_ = 0;
+    uint64_t processed_seq_ = 0;
+    AdaptiveBatchWindow batch_window_;
+
+    // Ticks re-run the DAG for delayed outputs and continuous simulation, at
+    // tick_hz if there are Lua mappings; with tick_hz 0 or only native
+    // mappings the owner sleeps until a command or native deadline
+    std::chrono::steady_clock::duration tick_interval_{};  // Zero: no ticks
+    std::chrono::steady_clock::time_point next_tick_ = std::chrono::steady_clock::time_point::max();
+
+    // Replicas are polled by a shared pool instead of running their own loop
+    WorkerPool* pool_ = nullptr;
+    size_t pool_id_ = 0;
+    bool seeded_ = false;
+    std::vector<PendingActuation> pool_batch_;
+
+    // Metrics
+    MetricsRegistry& metrics_;
+    Counter& actuations_total_;
+    Counter& immediate_acks_total_;
+    Counter& ingress_full_total_;
+    Counter& rejected_total_;
+    Counter& stale_total_;
+    Counter& dag_passes_total_;
+    Counter& immediate_batches_total_;
+    Counter& windowed_batches_total_;
+    Histogram& batch_size_;
+    Histogram& queue_depth_;
+    Histogram& window_wait_us_;
+    Histogram& dag_eval_us_;
+
+    // Optional --capture sink, owned by main()
+    CaptureWriter* capture_ = nullptr;
+
+    // Outputs go to the broker channels and capture through per-sink queues
+    std::unique_ptr<OutputDispatcher> dispatcher_;
+
+    // Paths other fixtures also publish go through this merge, owned by main()
+    OutputMerge* merge_ = nullptr;
+
+    // Mappings for VssDAG: the fixture's Lua mappings reading served
+    // actuators' .target, plus native outputs that Lua mappings read
     std::unordered_map<std::string, SignalMapping> CreateDAGMappings() {
-        std::unordered_map<std::string, SignalMapping> dag_mappings;
-
-        // Transform user mappings: add .target suffix for served actuators
-        for (const auto& [signal_name, mapping] : config_.mappings) {
-            SignalMapping dag_mapping = mapping;
-
-            // Transform depends_on: add .target to served actuators
-            dag_mapping.depends_on.clear();
-            for (const auto& dep : mapping.depends_on) {
-                if (std::find(config_.serves.begin(), config_.serves.end(), dep) != config_.serves.end()) {
-                    dag_mapping.depends_on.push_back(dep + ".target");
-                } else {
-                    dag_mapping.depends_on.push_back(dep);
-                }
+        std::unordered_map<std::string, SignalMapping> dag_mappings = BuildDagMappings(config_);
+
+        // Native outputs read by Lua mappings enter the DAG as external inputs
+        native_feeds_dag_.assign(native_spec_.nodes.size(), false);
+        for (size_t k = 0; k < native_spec_.nodes.size(); ++k) {
+            const auto& native = native_spec_.nodes[k].mapping;
+            if (served_.contains(native.signal)) {
+                continue;  // Lua reads the served actuator's .target instead
             }
-
-            // Transform code: replace served actuator references with .target
-            if (std::holds_alternative<vssdag::CodeTransform>(mapping.transform)) {
-                std::string code = std::get<vssdag::CodeTransform>(mapping.transform).expression;
-
-                for (const auto& actuator : config_.serves) {
-                    // Find and replace: deps["actuator"] -> deps["actuator.target"]
-                    std::string search = "deps[\"" + actuator + "\"]";
-                    std::string replace = "deps[\"" + actuator + ".target\"]";
-                    size_t pos = 0;
-                    while ((pos = code.find(search, pos)) != std::string::npos) {
-                        code.replace(pos, search.length(), replace);
-                        pos += replace.length();
-                    }
-                    // Also handle single quotes: deps['actuator']
-                    search = "deps['" + actuator + "']";
-                    replace = "deps['" + actuator + ".target']";
-                    pos = 0;
-                    while ((pos = code.find(search, pos)) != std::string::npos) {
-                        code.replace(pos, search.length(), replace);
-                        pos += replace.length();
-                    }
+            for (const auto& [signal_name, mapping] : config_.mappings) {
+                const auto& deps = mapping.depends_on;
+                if (std::find(deps.begin(), deps.end(), native.signal) != deps.end()) {
+                    SignalMapping source_mapping;
+                    source_mapping.datatype = native.datatype;
+                    source_mapping.source = vssdag::SignalSource{"native", native.signal};
+                    dag_mappings[native.signal] = source_mapping;
+                    native_feeds_dag_[k] = true;
+                    break;
                 }
-
-                dag_mapping.transform = vssdag::CodeTransform{.expression = code};
-            }
-
-            dag_mappings[signal_name] = dag_mapping;
-        }
-
-        // Add .target signals as source signals (external inputs)
-        for (const auto& actuator : config_.serves) {
-            std::string target_signal = actuator + ".target";
-            if (dag_mappings.find(target_signal) == dag_mappings.end()) {
-                SignalMapping target_mapping;
-                target_mapping.datatype = vss::types::ValueType::UNSPECIFIED;
-                // Mark as input signal by setting source
-                target_mapping.source = vssdag::SignalSource{"actuator", target_signal};
-                // No depends_on = external input signal
-                dag_mappings[target_signal] = target_mapping;
             }
         }
 
@@ -109,305 +188,663 @@ private:
     }
 
 public:
-    FixtureRunner(const std::string& kuksa_address)
-        : kuksa_address_(kuksa_address) {
+    FixtureRunner(BrokerPool& brokers, const std::string& kuksa_address, MetricsRegistry& metrics)
+        : brokers_(brokers),
+          kuksa_address_(kuksa_address),
+          metrics_(metrics),
+          actuations_total_(metrics.counter("ingress.actuations_total")),
+          immediate_acks_total_(metrics.counter("ingress.immediate_acks_total")),
+          ingress_full_total_(metrics.counter("ingress.full_total")),
+          rejected_total_(metrics.counter("ingress.rejected_total")),
+          stale_total_(metrics.counter("watchdog.stale_total")),
+          dag_passes_total_(metrics.counter("dag.passes_total")),
+          immediate_batches_total_(metrics.counter("dag.batches_immediate_total")),
+          windowed_batches_total_(metrics.counter("dag.batches_windowed_total")),
+          batch_size_(metrics.histogram("dag.batch_size")),
+          queue_depth_(metrics.histogram("ingress.queue_depth")),
+          window_wait_us_(metrics.histogram("dag.window_wait_us")),
+          dag_eval_us_(metrics.histogram("dag.eval_us")) {
     }
 
-    void LoadConfig(const std::string& config_file) {
-        // Check if file exists and is a regular file
-        struct stat st;
-        if (stat(config_file.c_str(), &st) != 0) {
-            LOG(ERROR) << "Config file does not exist: " << config_file;
-            return;
-        }
-        if (S_ISDIR(st.st_mode)) {
-            LOG(ERROR) << "Config path is a directory, not a file: " << config_file;
-            return;
-        }
-
-        try {
-            YAML::Node root = YAML::LoadFile(config_file);
+    void SetCapture(CaptureWriter* capture) {
+        capture_ = capture;
+    }
 
-            if (!root["fixture"]) {
-                LOG(ERROR) << "No 'fixture' section in config";
-                return;
-            }
+    void SetMerge(OutputMerge* merge) {
+        merge_ = merge;
+    }
 
-            const YAML::Node& fixture = root["fixture"];
+    // Serve every signal as |prefix| + path on the broker. Mappings keep the
+    // paths of the fixture file, so replicas share its compiled program.
+    void SetPathPrefix(const std::string& prefix) {
+        path_prefix_ = prefix;
+    }
 
-            // Parse fixture name
-            config_.name = fixture["name"].as<std::string>("Unnamed Fixture");
+    // Be polled by |pool| (as task |id|) rather than by a thread in Run().
+    // The sinks are written inline, so a pooled runner has no threads.
+    void SetPool(WorkerPool* pool, size_t id) {
+        pool_ = pool;
+        pool_id_ = id;
+    }
 
-            // Parse serves section
-            if (!fixture["serves"]) {
-                LOG(ERROR) << "No 'serves' section in fixture config";
-                return;
-            }
+    void Configure(FixtureConfig config) {
+        config_ = std::move(config);
+        if (!config_.broker.empty()) {
+            kuksa_address_ = config_.broker;
+        }
+    }
 
-            for (const auto& signal_node : fixture["serves"]) {
-                std::string signal_path = signal_node.as<std::string>();
-                config_.serves.push_back(signal_path);
+    // Resolve signals, register actuators and build the graphs. The broker
+    // clients are started afterwards by BrokerPool::start().
+    std::optional<StartupFailure> Start() {
+        connection_ = brokers_.get(kuksa_address_);
+        if (!connection_) {
+            return Failure(StartupError::BROKER_UNREACHABLE, "Cannot connect to databroker " + kuksa_address_);
+        }
+        resolver_ = connection_->resolver.get();
+        client_ = connection_->client;
+        for (const auto& actuator_path : config_.serves) {
+            if (!brokers_.claim(kuksa_address_, path_prefix_ + actuator_path, config_.name)) {
+                return Failure(StartupError::REGISTRATION,
+                               "Actuator " + path_prefix_ + actuator_path + " is served by another fixture");
             }
+        }
 
-            LOG(INFO) << "Fixture '" << config_.name << "' will serve "
-                      << config_.serves.size() << " actuator(s)";
+        // Index served actuators
+        served_ = PathTrie(config_.serves);
+        for (const auto& actuator_path : config_.serves) {
+            target_signals_.push_back(actuator_path + ".target");
+        }
 
-            // Parse mappings section (VssDAG format)
-            if (!fixture["mappings"]) {
-                LOG(ERROR) << "No 'mappings' section in fixture config";
-                return;
+        // Wire native mappings
+        if (auto error = BuildNativeGraphSpec(config_.native_mappings, config_.serves, native_spec_)) {
+            LOG(ERROR) << "Invalid native mappings: " << *error;
+            return Failure(StartupError::CONFIG, "Invalid native mappings: " + *error);
+        }
+        native_slots_.assign(config_.serves.size(), -1);
+        for (size_t slot = 0; slot < native_spec_.inputs.size(); ++slot) {
+            native_slots_[*served_.find(native_spec_.inputs[slot])] = static_cast<int>(slot);
+        }
+        if (!native_spec_.nodes.empty()) {
+            bool compiled = false;
+            native_program_ = CreateNativeProgram(native_spec_, config_.seed, &compiled);
+            LOG(INFO) << "Evaluating " << native_spec_.nodes.size() << " native mapping(s) with "
+                      << (compiled ? "compiled program" : "interpreter");
+            for (const auto& node : native_spec_.nodes) {
+                native_signals_.insert(node.mapping.signal);
             }
+        }
 
-            for (const auto& mapping_node : fixture["mappings"]) {
-                if (!mapping_node["signal"]) {
-                    continue;
-                }
-
-                std::string signal_name = mapping_node["signal"].as<std::string>();
-                SignalMapping mapping;
-
-                // Parse datatype
-                if (mapping_node["datatype"]) {
-                    std::string datatype_str = mapping_node["datatype"].as<std::string>();
-                    auto datatype_opt = vss::types::value_type_from_string(datatype_str);
-                    if (datatype_opt.has_value()) {
-                        mapping.datatype = *datatype_opt;
-                    } else {
-                        LOG(WARNING) << "Unknown datatype '" << datatype_str << "' for signal " << signal_name;
-                        mapping.datatype = vss::types::ValueType::UNSPECIFIED;
-                    }
+        // Native nodes reading each served actuator, directly or through other nodes
+        const size_t native_inputs = native_spec_.inputs.size();
+        std::vector<std::vector<uint8_t>> reads(native_spec_.nodes.size(), std::vector<uint8_t>(native_inputs, 0));
+        native_downstream_.assign(config_.serves.size(), {});
+        for (size_t k = 0; k < native_spec_.nodes.size(); ++k) {
+            for (uint32_t slot : native_spec_.nodes[k].input_slots) {
+                if (slot < native_inputs) {
+                    reads[k][slot] = 1;
                 } else {
-                    mapping.datatype = vss::types::ValueType::UNSPECIFIED;
-                }
-
-                // Parse depends_on (keep original signal names)
-                if (mapping_node["depends_on"]) {
-                    for (const auto& dep : mapping_node["depends_on"]) {
-                        std::string dep_signal = dep.as<std::string>();
-                        mapping.depends_on.push_back(dep_signal);
+                    const auto& upstream = reads[slot - native_inputs];
+                    for (size_t i = 0; i < native_inputs; ++i) {
+                        reads[k][i] |= upstream[i];
                     }
                 }
-
-                // Parse delay (convert to interval_ms for DAG)
-                if (mapping_node["delay"]) {
-                    double delay_seconds = mapping_node["delay"].as<double>();
-                    mapping.interval_ms = static_cast<int>(delay_seconds * 1000);
-                }
-
-                // Parse transform code (keep original signal names)
-                if (mapping_node["transform"] && mapping_node["transform"]["code"]) {
-                    std::string code = mapping_node["transform"]["code"].as<std::string>();
-                    mapping.transform = vssdag::CodeTransform{.expression = code};
+            }
+            for (size_t i = 0; i < native_inputs; ++i) {
+                if (reads[k][i]) {
+                    native_downstream_[*served_.find(native_spec_.inputs[i])].push_back(static_cast<uint32_t>(k));
                 }
-
-                config_.mappings[signal_name] = mapping;
             }
-
-            LOG(INFO) << "Loaded " << config_.mappings.size() << " signal mappings";
-
-        } catch (const YAML::Exception& e) {
-            LOG(ERROR) << "Failed to parse YAML config: " << e.what();
         }
-    }
-
-    void Start() {
-        // Create resolver
-        auto resolver_result = Resolver::create(kuksa_address_);
-        if (!resolver_result.ok()) {
-            LOG(ERROR) << "Failed to create resolver: " << resolver_result.status();
-            running_ = false;
-            return;
-        }
-        resolver_ = std::move(*resolver_result);
-
-        // Create client
-        auto client_result = Client::create(kuksa_address_);
-        if (!client_result.ok()) {
-            LOG(ERROR) << "Failed to create client: " << client_result.status();
-            running_ = false;
-            return;
-        }
-        client_ = std::move(*client_result);
+        batch_pass_of_.assign(config_.serves.size(), 0);
+        last_command_.assign(config_.serves.size(), {});
+        watched_.assign(config_.serves.size(), 0);
+        stale_.assign(config_.serves.size(), 0);
+        native_stale_inputs_.assign(native_spec_.nodes.size(), 0);
+        native_last_.assign(native_spec_.nodes.size(), std::nullopt);
+        native_emitted_pass_.assign(native_spec_.nodes.size(), 0);
 
         // Pre-resolve all signal handles (for served actuators and DAG outputs)
         std::unordered_set<std::string> all_signals(config_.serves.begin(), config_.serves.end());
         for (const auto& [signal_path, mapping] : config_.mappings) {
             all_signals.insert(signal_path);
         }
+        all_signals.insert(native_signals_.begin(), native_signals_.end());
 
+        // Merged paths use a channel past the broker's own
+        const size_t merge_channel = connection_->publishers.size();
+        bool any_merged = false;
+        signal_handles_.reserve(all_signals.size());
         for (const auto& signal_path : all_signals) {
-            auto handle_result = resolver_->get_dynamic(signal_path);
+            const std::string broker_path = path_prefix_ + signal_path;
+            auto handle_result = resolver_->get_dynamic(broker_path);
             if (!handle_result.ok()) {
-                LOG(ERROR) << "Failed to resolve signal " << signal_path
+                LOG(ERROR) << "Failed to resolve signal " << broker_path
                           << ": " << handle_result.status();
                 LOG(ERROR) << "Cannot start fixture - signal resolution failed";
-                running_ = false;
-                return;  // FAIL FAST - critical error
+                std::ostringstream detail;
+                detail << "Failed to resolve signal " << broker_path << ": " << handle_result.status();
+                // A broker lost since get() is transient, not an unknown signal
+                if (!BrokerPool::reachable(kuksa_address_)) {
+                    return Failure(StartupError::BROKER_UNREACHABLE, detail.str());
+                }
+                return Failure(StartupError::RESOLUTION, detail.str());  // FAIL FAST - critical error
             }
-            signal_handles_[signal_path] = *handle_result;
+            const bool merged = merge_ && merge_->covers(broker_path);
+            any_merged |= merged;
+            signal_handles_[signal_path] = OutputTarget{
+                broker_path, *handle_result, merged ? merge_channel : connection_->channel_for(broker_path)};
         }
 
-        // Register actuator handlers for all served actuators
-        for (const auto& actuator_path : config_.serves) {
-            auto it = signal_handles_.find(actuator_path);
+        // Register actuator handlers for all served actuators. Each handler
+        // carries only its index into config_.serves; the client sends the
+        // whole set in one provider registration when it starts.
+        for (size_t actuator = 0; actuator < config_.serves.size(); ++actuator) {
+            auto it = signal_handles_.find(config_.serves[actuator]);
             if (it == signal_handles_.end()) {
-                LOG(ERROR) << "Cannot register actuator " << actuator_path
+                LOG(ERROR) << "Cannot register actuator " << config_.serves[actuator]
                           << " - signal handle not resolved";
-                running_ = false;
-                return;  // FAIL FAST - critical error
+                return Failure(StartupError::REGISTRATION, "Cannot register actuator " +
+                               config_.serves[actuator] + " - signal handle not resolved");  // FAIL FAST
             }
 
-            LOG(INFO) << "Registering actuator: " << actuator_path;
+            VLOG(1) << "Registering actuator: " << config_.serves[actuator];
 
-            client_->serve_actuator(*it->second,
-                [this, actuator_path](
+            client_->serve_actuator(*it->second.handle,
+                [this, actuator](
                     const vss::types::Value& target, const DynamicSignalHandle& handle) {
-                    HandleActuation(actuator_path, target);
+                    HandleActuation(actuator, target);
                 }
             );
         }
 
         // Initialize DAG processor with transformed mappings (.target suffix added)
         dag_processor_ = std::make_unique<SignalProcessorDAG>();
+        has_dag_mappings_ = !config_.mappings.empty();
         auto dag_mappings = CreateDAGMappings();
         LOG(INFO) << "Created " << dag_mappings.size() << " DAG mappings (including "
                   << config_.serves.size() << " .target inputs)";
         if (!dag_processor_->initialize(dag_mappings)) {
             LOG(ERROR) << "Failed to initialize DAG processor";
-            running_ = false;
-            return;
+            return Failure(StartupError::DAG_INIT, "Failed to initialize DAG processor");
         }
 
-        // Start client
-        auto start_status = client_->start();
-        if (!start_status.ok()) {
-            LOG(ERROR) << "Failed to start client: " << start_status;
-            running_ = false;
-            return;
+        // One queue per broker channel, plus capture, which drops rather than
+        // hold up publishing when the disk falls behind. Pooled runners write
+        // their sinks from the pool thread instead.
+        dispatcher_ = std::make_unique<OutputDispatcher>(metrics_, [this](uint64_t seq) {
+            {
+                std::lock_guard<std::mutex> lock(ingress_mutex_);
+                processed_seq_ = seq;
+            }
+            processed_cv_.notify_all();
+        });
+        for (size_t channel = 0; channel < connection_->publishers.size(); ++channel) {
+            OutputDispatcher::SinkOptions options;
+            options.acknowledges = true;
+            options.channel = channel;
+            options.inline_write = pool_ != nullptr;
+            dispatcher_->add_sink("broker" + std::to_string(channel),
+                                  std::make_unique<BrokerSink>(*connection_->publishers[channel]), options);
+        }
+        if (any_merged) {
+            OutputDispatcher::SinkOptions options;
+            options.acknowledges = true;
+            options.channel = merge_channel;
+            options.inline_write = pool_ != nullptr;
+            dispatcher_->add_sink("merge", std::make_unique<MergeSink>(*merge_, config_.precedence), options);
+        }
+        if (capture_) {
+            OutputDispatcher::SinkOptions options;
+            options.drop_when_full = true;
+            options.inline_write = pool_ != nullptr;
+            dispatcher_->add_sink("capture", std::make_unique<CaptureSink>(*capture_), options);
         }
 
-        // Wait for client to be ready
-        auto ready_status = client_->wait_until_ready(std::chrono::seconds(10));
-        if (!ready_status.ok()) {
-            LOG(ERROR) << "Client not ready: " << ready_status;
-            running_ = false;
-            return;
+        if (capture_) {
+            capture_->record_seed(config_.name, config_.seed);
         }
 
         // SUCCESS - mark as running
+        batch_window_ = AdaptiveBatchWindow(config_.batching);
+        if (config_.tick_hz > 0 && has_dag_mappings_) {
+            tick_interval_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / config_.tick_hz));
+            next_tick_ = std::chrono::steady_clock::now() + tick_interval_;
+            VLOG(1) << "[" << config_.name << "] Ticking at " << config_.tick_hz << " Hz";
+        }
+        dispatcher_->start();
         running_ = true;
 
         LOG(INFO) << "Started fixture '" << config_.name << "' serving "
-                  << config_.serves.size() << " actuator(s)";
+                  << config_.serves.size() << " actuator(s) on " << kuksa_address_
+                  << (path_prefix_.empty() ? "" : " under " + path_prefix_) << ", seed " << config_.seed;
+        return std::nullopt;
     }
 
+    // DAG owner loop: drains actuations in adaptive batches and ticks at
+    // tick_hz
     void Run() {
-        // Run at 10Hz to process DAG for delayed outputs and continuous simulation
-        const auto tick_interval = std::chrono::milliseconds(100);  // 10Hz
+        std::vector<PendingActuation> batch;
+        batch.reserve(config_.batching.max_batch);
+        Seed(batch);
 
         while (running_) {
-            // Process DAG periodically to handle:
-            // 1. Delayed outputs (signals with interval_ms/delay)
-            // 2. Continuous simulation (periodic signals)
-            // Call with empty updates to trigger time-based processing
-            std::vector<vssdag::SignalUpdate> empty_updates;
-            std::vector<vssdag::VSSSignal> outputs = dag_processor_->process_signal_updates(empty_updates);
-
-            // Publish any outputs from DAG
-            for (const auto& vss_signal : outputs) {
-                if (!vss_signal.qualified_value.is_valid()) {
-                    continue;
-                }
-
-                auto handle_it = signal_handles_.find(vss_signal.path);
-                if (handle_it == signal_handles_.end()) {
-                    LOG(WARNING) << "No handle for output signal: " << vss_signal.path;
-                    continue;
-                }
-
-                LOG(INFO) << "[" << config_.name << "] Publishing DAG output: " << vss_signal.path;
+            batch.clear();
+            CollectBatch(batch, NextWake());
+            Turn(batch);
+        }
 
-                auto status = client_->publish(*handle_it->second, vss_signal.qualified_value);
-                if (!status.ok()) {
-                    LOG(ERROR) << "Failed to publish " << vss_signal.path << ": " << status;
-                }
-            }
+        // Outputs already queued still go out
+        dispatcher_->stop();
+    }
 
-            // Sleep for 100ms (10Hz tick rate)
-            std::this_thread::sleep_for(tick_interval);
+    // Pooled DAG owner: one turn on a pool thread. Takes what is queued
+    // without a batching window, so it never blocks the pool, and returns
+    // when the next turn is due.
+    std::chrono::steady_clock::time_point poll() override {
+        if (!running_) {
+            return std::chrono::steady_clock::time_point::max();
         }
+        if (!seeded_) {
+            seeded_ = true;
+            pool_batch_.reserve(config_.batching.max_batch);
+            Seed(pool_batch_);
+        }
+        pool_batch_.clear();
+        const bool more = TakeQueued(pool_batch_);
+        Turn(pool_batch_);
+        return more ? std::chrono::steady_clock::now() : NextWake();
     }
 
     bool IsRunning() const {
         return running_;
     }
 
+    // Broker clients are stopped by their BrokerPool
     void Stop() {
         running_ = false;
+        ingress_cv_.notify_all();
+        processed_cv_.notify_all();
+        LOG(INFO) << "Fixture '" << config_.name << "' stopped";
+    }
 
-        if (client_) {
-            client_->stop();
+private:
+    StartupFailure Failure(StartupError error, std::string detail) const {
+        return StartupFailure{error, std::move(detail), config_.name};
+    }
+
+    // Handle actuation request from databroker.
+    // Enqueues for the DAG owner thread. With ack: processed (the default) it
+    // returns once the resulting outputs have been published, so the commanding
+    // set() keeps its synchronous semantics; with ack: immediate it returns as
+    // soon as the command is queued, waiting only while the queue is full.
+    // Commands failing the actuator's accept rules are dropped here.
+    void HandleActuation(size_t actuator, const vss::types::Value& target) {
+        VLOG(1) << "[" << config_.name << "] Received actuation: " << config_.serves[actuator];
+        actuations_total_.inc();
+
+        const bool immediate = config_.actuators[actuator].ack == AckMode::IMMEDIATE;
+
+        const auto received = std::chrono::steady_clock::now();
+
+        // The one copy of the command, made outside the lock; it is moved from
+        // here into the ingress queue, the batch and the DAG update
+        vss::types::Value value(target);
+
+        std::unique_lock<std::mutex> lock(ingress_mutex_);
+        auto& accept = config_.actuators[actuator].accept;
+        if (!accept.empty()) {
+            if (const char* reason = accept.check(value, received)) {
+                rejected_total_.inc();
+                LOG_EVERY_N(WARNING, 100) << "[" << config_.name << "] Rejected command for "
+                                          << config_.serves[actuator] << ": " << reason;
+                return;
+            }
         }
-        LOG(INFO) << "Fixture stopped";
+        if (immediate && ingress_.size() >= config_.max_queued) {
+            ingress_full_total_.inc();
+            processed_cv_.wait(lock, [&] { return ingress_.size() < config_.max_queued || !running_; });
+        }
+        const uint64_t seq = ++enqueued_seq_;
+
+        ingress_.push_back(PendingActuation{
+            seq,
+            actuator,
+            std::move(value),
+            received
+        });
+        ingress_cv_.notify_one();
+        if (pool_) {
+            pool_->wake(pool_id_);
+        }
+
+        if (immediate) {
+            immediate_acks_total_.inc();
+            return;
+        }
+        processed_cv_.wait(lock, [&] { return processed_seq_ >= seq || !running_; });
     }
 
-private:
-    // Handle actuation request from databroker
-    void HandleActuation(const std::string& actuator_path, const vss::types::Value& target) {
-        LOG(INFO) << "[" << config_.name << "] Received actuation: " << actuator_path;
+    // Wait until actuations are pending or |deadline| passes, then move up to
+    // max_batch of them into |batch|. Under load the adaptive window holds the
+    // batch open briefly so a burst becomes one DAG pass.
+    void CollectBatch(std::vector<PendingActuation>& batch,
+                      std::chrono::steady_clock::time_point deadline) {
+        std::unique_lock<std::mutex> lock(ingress_mutex_);
+        if (deadline == std::chrono::steady_clock::time_point::max()) {
+            ingress_cv_.wait(lock, [&] { return !ingress_.empty() || !running_; });
+        } else {
+            ingress_cv_.wait_until(lock, deadline, [&] { return !ingress_.empty() || !running_; });
+        }
+        if (ingress_.empty()) {
+            return;
+        }
+
+        const size_t max_batch = batch_window_.options().max_batch;
+        queue_depth_.observe(ingress_.size());
+
+        const auto window = batch_window_.window_for(ingress_.size());
+        if (window.count() > 0) {
+            const auto opened = std::chrono::steady_clock::now();
+            ingress_cv_.wait_until(lock, opened + window,
+                [&] { return ingress_.size() >= max_batch || !running_; });
+            windowed_batches_total_.inc();
+            window_wait_us_.observe(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - opened).count());
+        } else {
+            immediate_batches_total_.inc();
+        }
+
+        const size_t n = std::min(max_batch, ingress_.size());
+        for (size_t i = 0; i < n; ++i) {
+            batch.push_back(std::move(ingress_.front()));
+            ingress_.pop_front();
+        }
+    }
+
+    // Move up to max_batch queued actuations into |batch| without waiting.
+    // Returns true if more are still queued.
+    bool TakeQueued(std::vector<PendingActuation>& batch) {
+        std::lock_guard<std::mutex> lock(ingress_mutex_);
+        if (ingress_.empty()) {
+            return false;
+        }
+        queue_depth_.observe(ingress_.size());
+        immediate_batches_total_.inc();
+        const size_t n = std::min(batch_window_.options().max_batch, ingress_.size());
+        for (size_t i = 0; i < n; ++i) {
+            batch.push_back(std::move(ingress_.front()));
+            ingress_.pop_front();
+        }
+        return !ingress_.empty();
+    }
 
-        // Transform actuation to .target signal for VssDAG
-        // This allows DAG to distinguish between TARGET (input) and ACTUAL (output)
-        std::string target_signal = actuator_path + ".target";
+    // Earliest native delay or watchdog deadline, if any
+    std::optional<std::chrono::steady_clock::time_point> TimerDeadline() const {
+        std::optional<std::chrono::steady_clock::time_point> deadline;
+        if (native_program_) {
+            deadline = native_program_->next_deadline();
+        }
+        const auto watchdog_deadline = watchdog_.next_deadline();
+        if (watchdog_deadline && (!deadline || *watchdog_deadline < *deadline)) {
+            deadline = watchdog_deadline;
+        }
+        return deadline;
+    }
 
-        vssdag::SignalUpdate update{
-            target_signal,  // Use .target suffix for DAG input
-            target,
-            std::chrono::steady_clock::now(),
-            vss::types::SignalQuality::VALID
-        };
+    // Native delays and the watchdog fire on time rather than on the next tick
+    std::chrono::steady_clock::time_point NextWake() const {
+        const auto deadline = TimerDeadline();
+        return deadline && *deadline < next_tick_ ? *deadline : next_tick_;
+    }
+
+    // Evaluate |batch| and whatever timers are due. Passes with nothing to
+    // do are skipped.
+    void Turn(std::vector<PendingActuation>& batch) {
+        const auto now = std::chrono::steady_clock::now();
+        const auto deadline = TimerDeadline();
+        const bool tick_due = now >= next_tick_;
+        const bool native_due = deadline && now >= *deadline;
+        if (batch.empty() && !tick_due && !native_due) {
+            return;
+        }
+
+        // Process DAG on actuations and periodically to handle:
+        // 1. Delayed outputs (signals with interval_ms/delay)
+        // 2. Continuous simulation (periodic signals)
+        // A tick is a pass with empty updates to trigger time-based processing.
+        // A pass takes one command per actuator, so stateful mappings see
+        // every command of a burst; a repeat starts the next pass.
+        auto pass_begin = batch.begin();
+        ++batch_pass_;
+        for (auto it = batch.begin(); it != batch.end(); ++it) {
+            if (batch_pass_of_[it->actuator] == batch_pass_) {
+                ProcessBatch(pass_begin, it);
+                pass_begin = it;
+                ++batch_pass_;
+            }
+            batch_pass_of_[it->actuator] = batch_pass_;
+        }
+        ProcessBatch(pass_begin, batch.end());
+
+        if (tick_due) {
+            next_tick_ += tick_interval_;
+            if (next_tick_ <= now) {
+                next_tick_ = now + tick_interval_;
+            }
+        }
+    }
 
-        // Process through DAG
-        std::vector<vssdag::SignalUpdate> updates = {update};
-        LOG(INFO) << "[" << config_.name << "] Processing DAG with input: " << target_signal;
+    // Evaluate one pass over the actuations in [begin, end) (none = tick),
+    // at most one per actuator: native mappings first, then the DAG. Queues
+    // the outputs; the callbacks waiting on them are released once the
+    // broker channels have published them.
+    void ProcessBatch(std::vector<PendingActuation>::iterator begin, std::vector<PendingActuation>::iterator end) {
+        const auto now = std::chrono::steady_clock::now();
+        const size_t count = static_cast<size_t>(end - begin);
+        ++pass_;
+        std::vector<vssdag::SignalUpdate> updates;
+        updates.reserve(count);
+        std::vector<uint32_t> refreshed_nodes;
+        std::vector<uint32_t> stale_nodes;
+        for (auto it = begin; it != end; ++it) {
+            auto& actuation = *it;
+            Refresh(actuation.actuator, actuation.received, refreshed_nodes);
+            const int slot = native_slots_[actuation.actuator];
+            if (slot >= 0) {
+                if (auto native_value = NativeValueFromVss(actuation.value)) {
+                    native_program_->set_input(static_cast<uint32_t>(slot), *native_value);
+                } else {
+                    LOG(WARNING) << "Non-numeric command for " << config_.serves[actuation.actuator]
+                                 << " ignored by native mappings";
+                }
+            }
 
-        // Debug: Check if we have required input signals
-        auto required_inputs = dag_processor_->get_required_input_signals();
-        LOG(INFO) << "[" << config_.name << "] DAG expects " << required_inputs.size() << " input signals";
-        for (const auto& input : required_inputs) {
-            LOG(INFO) << "[" << config_.name << "]   - " << input;
+            // Transform actuation to .target signal for VssDAG
+            // This allows DAG to distinguish between TARGET (input) and ACTUAL (output)
+            updates.push_back(vssdag::SignalUpdate{
+                target_signals_[actuation.actuator],
+                std::move(actuation.value),
+                actuation.received,
+                vss::types::SignalQuality::VALID
+            });
         }
 
-        std::vector<vssdag::VSSSignal> outputs = dag_processor_->process_signal_updates(updates);
-        LOG(INFO) << "[" << config_.name << "] DAG produced " << outputs.size() << " output(s)";
+        CheckStaleness(now, updates, stale_nodes);
 
-        // Debug: Log all outputs
-        for (const auto& vss_signal : outputs) {
-            LOG(INFO) << "[" << config_.name << "]   Output: " << vss_signal.path
-                      << " (valid=" << vss_signal.qualified_value.is_valid() << ")";
+        std::vector<vssdag::VSSSignal> outputs;
+        if (native_program_) {
+            native_outputs_.clear();
+            native_program_->evaluate(now, native_outputs_);
+            for (const auto& native : native_outputs_) {
+                native_last_[native.node] = native.value;
+                if (native_stale_inputs_[native.node] > 0) {
+                    continue;  // Held back until its inputs are fresh again
+                }
+                native_emitted_pass_[native.node] = pass_;
+                EmitNative(native.node, VssValueFromNative(native.value, native_spec_.nodes[native.node].mapping.datatype),
+                           vss::types::SignalQuality::VALID, now, updates, outputs);
+            }
         }
 
-        // Publish all DAG output signals (these are ACTUAL values)
-        for (const auto& vss_signal : outputs) {
-            if (!vss_signal.qualified_value.is_valid()) {
-                LOG(WARNING) << "Skipping invalid output signal: " << vss_signal.path;
-                continue;
+        // Quality transitions of native nodes whose inputs went stale or recovered
+        for (uint32_t node : stale_nodes) {
+            if (native_stale_inputs_[node] > 0) {
+                EmitNative(node, vss::types::Value{}, vss::types::SignalQuality::NOT_AVAILABLE, now, updates, outputs);
+            }
+        }
+        for (uint32_t node : refreshed_nodes) {
+            if (native_stale_inputs_[node] == 0 && native_emitted_pass_[node] != pass_ && native_last_[node]) {
+                EmitNative(node, VssValueFromNative(*native_last_[node], native_spec_.nodes[node].mapping.datatype),
+                           vss::types::SignalQuality::VALID, now, updates, outputs);
+            }
+        }
+
+        if (has_dag_mappings_) {
+            const auto eval_start = std::chrono::steady_clock::now();
+            std::vector<vssdag::VSSSignal> dag_outputs = dag_processor_->process_signal_updates(updates);
+            dag_eval_us_.observe(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - eval_start).count());
+            dag_passes_total_.inc();
+
+            for (auto& vss_signal : dag_outputs) {
+                if (!native_signals_.count(vss_signal.path)) {
+                    outputs.push_back(std::move(vss_signal));
+                }
+            }
+        }
+
+        if (count > 0) {
+            batch_size_.observe(count);
+            VLOG(1) << "[" << config_.name << "] Pass over " << count
+                    << " actuation(s) produced " << outputs.size() << " output(s)";
+        }
+
+        PublishOutputs(outputs);
+
+        if (count > 0) {
+            dispatcher_->seal(std::prev(end)->seq);
+        }
+    }
+
+    // Publish the initial values together, then evaluate those of served
+    // actuators once as if commanded, so outputs derived from them agree.
+    // Runs on the DAG owner thread before any queued command.
+    void Seed(std::vector<PendingActuation>& batch) {
+        if (config_.initial.empty()) {
+            return;
+        }
+        const auto now = std::chrono::steady_clock::now();
+        std::vector<vssdag::VSSSignal> outputs;
+        for (const auto& [signal, value] : config_.initial) {
+            vssdag::VSSSignal output;
+            output.path = signal;
+            output.qualified_value = MakeQualifiedOutput(value, vss::types::SignalQuality::VALID);
+            outputs.push_back(std::move(output));
+
+            if (auto served = served_.find(signal)) {
+                batch.push_back(PendingActuation{0, *served, value, now});
+            }
+        }
+        {
+            // The first command's rate is measured from the initial value
+            std::lock_guard<std::mutex> lock(ingress_mutex_);
+            for (const auto& seeded : batch) {
+                config_.actuators[seeded.actuator].accept.prime(seeded.value, now);
+            }
+        }
+        PublishOutputs(outputs);
+        ProcessBatch(batch.begin(), batch.end());
+        LOG(INFO) << "[" << config_.name << "] Published " << outputs.size() << " initial value(s)";
+    }
+
+    // Output of native node |node|, also fed to the DAG if Lua mappings read it
+    void EmitNative(uint32_t node, vss::types::Value value, vss::types::SignalQuality quality,
+                    std::chrono::steady_clock::time_point now, std::vector<vssdag::SignalUpdate>& updates,
+                    std::vector<vssdag::VSSSignal>& outputs) {
+        const auto& mapping = native_spec_.nodes[node].mapping;
+        vssdag::VSSSignal signal;
+        signal.path = mapping.signal;
+        signal.qualified_value = MakeQualifiedOutput(std::move(value), quality);
+        if (native_feeds_dag_[node]) {
+            updates.push_back(vssdag::SignalUpdate{mapping.signal, signal.qualified_value.value, now, quality});
+        }
+        outputs.push_back(std::move(signal));
+    }
+
+    // A command for |actuator| arrived at |received|: re-arm its watchdog and
+    // collect the native nodes that stop being stale
+    void Refresh(size_t actuator, std::chrono::steady_clock::time_point received,
+                 std::vector<uint32_t>& refreshed_nodes) {
+        const auto max_age = config_.actuators[actuator].max_age;
+        if (max_age.count() == 0) {
+            return;
+        }
+        last_command_[actuator] = received;
+        if (!watched_[actuator]) {
+            watched_[actuator] = 1;
+            watchdog_.schedule(static_cast<uint32_t>(actuator), received + max_age);
+        }
+        if (stale_[actuator]) {
+            stale_[actuator] = 0;
+            for (uint32_t node : native_downstream_[actuator]) {
+                if (--native_stale_inputs_[node] == 0) {
+                    refreshed_nodes.push_back(node);
+                }
             }
+        }
+    }
 
-            auto handle_it = signal_handles_.find(vss_signal.path);
-            if (handle_it == signal_handles_.end()) {
-                LOG(WARNING) << "No handle for output signal: " << vss_signal.path;
+    // Mark actuators stale whose last command is older than their max_age.
+    // The DAG sees NOT_AVAILABLE for their .target; native nodes reading
+    // them are collected in |stale_nodes|.
+    void CheckStaleness(std::chrono::steady_clock::time_point now, std::vector<vssdag::SignalUpdate>& updates,
+                        std::vector<uint32_t>& stale_nodes) {
+        expired_.clear();
+        watchdog_.advance(now, expired_);
+        for (uint32_t actuator : expired_) {
+            // Entries are not moved on every command, only checked when due
+            const auto deadline = last_command_[actuator] + config_.actuators[actuator].max_age;
+            if (deadline > now) {
+                watchdog_.schedule(actuator, deadline);
                 continue;
             }
+            watched_[actuator] = 0;
+            stale_[actuator] = 1;
+            stale_total_.inc();
+            VLOG(1) << "[" << config_.name << "] " << config_.serves[actuator] << " is stale";
+            updates.push_back(vssdag::SignalUpdate{
+                target_signals_[actuator], vss::types::Value{}, now, vss::types::SignalQuality::NOT_AVAILABLE});
+            for (uint32_t node : native_downstream_[actuator]) {
+                if (native_stale_inputs_[node]++ == 0) {
+                    stale_nodes.push_back(node);
+                }
+            }
+        }
+    }
 
-            LOG(INFO) << "[" << config_.name << "] Publishing DAG output: " << vss_signal.path;
-            LOG(INFO) << "[" << config_.name << "]   Value variant index: " << vss_signal.qualified_value.value.index();
-            LOG(INFO) << "[" << config_.name << "]   Value: " << vssdag::VSSTypeHelper::to_string(vss_signal.qualified_value.value);
+    // Queue all output signals (these are ACTUAL values) for the sinks
+    void PublishOutputs(std::vector<vssdag::VSSSignal>& outputs) {
+        for (auto& vss_signal : outputs) {
+            const bool valid = vss_signal.qualified_value.is_valid();
+            auto target_it = signal_handles_.find(vss_signal.path);
+            if (target_it == signal_handles_.end()) {
+                LOG_IF(WARNING, valid) << "No handle for output signal: " << vss_signal.path;
+                continue;
+            }
 
-            auto status = client_->publish(*handle_it->second, vss_signal.qualified_value);
-            if (!status.ok()) {
-                LOG(ERROR) << "Failed to publish " << vss_signal.path << ": " << status;
+            // Of invalid outputs only a valid signal going bad is published
+            OutputTarget& target = target_it->second;
+            if (!valid && target.quality != vss::types::SignalQuality::VALID) {
+                continue;
             }
+            target.quality = vss_signal.qualified_value.quality;
+
+            VLOG(1) << "[" << config_.name << "] Publishing DAG output: " << vss_signal.path
+                    << " = " << vssdag::VSSTypeHelper::to_string(vss_signal.qualified_value.value);
+
+            dispatcher_->dispatch(target_it->second, std::move(vss_signal.qualified_value));
         }
     }
 };
@@ -417,8 +854,25 @@ int main(int argc, char* argv[]) {
     google::InitGoogleLogging(argv[0]);
     FLAGS_logtostderr = 1;
 
+    // SIGTERM and SIGINT are taken with sigwait() once serving, so shutdown
+    // runs on the main thread; blocked before any thread starts so that
+    // every thread inherits the mask
+    sigset_t shutdown_signals;
+    sigemptyset(&shutdown_signals);
+    sigaddset(&shutdown_signals, SIGTERM);
+    sigaddset(&shutdown_signals, SIGINT);
+    pthread_sigmask(SIG_BLOCK, &shutdown_signals, nullptr);
+
     std::string kuksa_address = "databroker:55555";
-    std::string config_file = "/app/fixture.yaml";
+    std::vector<std::string> config_files;
+    std::string metrics_file;
+    std::string capture_file;
+    std::string startup_report_file;
+    int publish_channels = 1;
+    int merge_quantum_ms = 10;
+    int merge_hold_ms = 1000;
+    std::optional<uint64_t> seed;
+    int workers = std::max(1u, std::thread::hardware_concurrency());
 
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
@@ -426,25 +880,204 @@ int main(int argc, char* argv[]) {
         if (arg == "--kuksa" && i + 1 < argc) {
             kuksa_address = argv[++i];
         } else if (arg == "--config" && i + 1 < argc) {
-            config_file = argv[++i];
+            config_files.push_back(argv[++i]);
+        } else if (arg == "--metrics-file" && i + 1 < argc) {
+            metrics_file = argv[++i];
+        } else if (arg == "--capture" && i + 1 < argc) {
+            capture_file = argv[++i];
+        } else if (arg == "--startup-report" && i + 1 < argc) {
+            startup_report_file = argv[++i];
+        } else if (arg == "--publish-channels" && i + 1 < argc) {
+            publish_channels = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--merge-quantum-ms" && i + 1 < argc) {
+            merge_quantum_ms = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--merge-hold-ms" && i + 1 < argc) {
+            merge_hold_ms = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--workers" && i + 1 < argc) {
+            workers = std::max(1, std::atoi(argv[++i]));
         }
     }
+    if (config_files.empty()) {
+        config_files.push_back("/app/fixture.yaml");
+    }
 
     LOG(INFO) << "=== Hardware Fixture Runner ===" ;
     LOG(INFO) << "KUKSA address: " << kuksa_address;
-    LOG(INFO) << "Config file: " << config_file;
+    for (const auto& config_file : config_files) {
+        LOG(INFO) << "Config file: " << config_file;
+    }
 
-    FixtureRunner runner(kuksa_address);
-    runner.LoadConfig(config_file);
-    runner.Start();
+    // Every startup failure ends here, with the exit code of its type
+    StartupReport report;
+    auto fail = [&](StartupFailure failure) {
+        report.write(startup_report_file, failure);
+        return StartupExitCode(failure.error);
+    };
+
+    MetricsRegistry metrics;
+    std::unique_ptr<MetricsReporter> metrics_reporter;
+    if (!metrics_file.empty()) {
+        LOG(INFO) << "Metrics file: " << metrics_file;
+        metrics_reporter = std::make_unique<MetricsReporter>(metrics, metrics_file);
+    }
 
-    if (!runner.IsRunning()) {
-        LOG(ERROR) << "Failed to start fixture runner";
-        return 1;
+    std::unique_ptr<CaptureWriter> capture;
+    if (!capture_file.empty()) {
+        LOG(INFO) << "Capture file: " << capture_file;
+        capture = std::make_unique<CaptureWriter>(capture_file, metrics);
+        if (!capture->ok()) {
+            return fail(StartupFailure{StartupError::CAPTURE, "Cannot open capture file " + capture_file, ""});
+        }
     }
 
-    runner.Run();
+    // One runner per independent part of each fixture, and per replica
+    struct Part {
+        std::string config_file;
+        std::string broker;
+        FixtureConfig config;
+        std::string prefix;   // Of a replica's paths on the broker
+        bool pooled = false;  // Replicas share the worker pool
+    };
+    std::vector<Part> parts;
+    for (const auto& config_file : config_files) {
+        FixtureConfig config;
+        std::string message;
+        if (!LoadFixtureConfig(config_file, config, &message)) {
+            return fail(StartupFailure{StartupError::CONFIG, config_file + ": " + message, ""});
+        }
+        if (seed) {
+            SetFixtureSeed(config, *seed);
+        }
+        auto fixture_parts = PartitionFixtureConfig(config);
+        if (fixture_parts.size() > 1) {
+            LOG(INFO) << "Fixture '" << config.name << "' has " << fixture_parts.size()
+                      << " independent parts, evaluated concurrently";
+        }
+        if (config.replicas > 1) {
+            LOG(INFO) << "Fixture '" << config.name << "' has " << config.replicas
+                      << " replicas, evaluated by " << workers << " pool thread(s)";
+        }
+        for (const auto& part : fixture_parts) {
+            for (size_t replica = 0; replica < config.replicas; ++replica) {
+                Part replica_part{config_file, "", part, "", config.replicas > 1};
+                if (replica_part.pooled) {
+                    replica_part.config.name += " [" + std::to_string(replica) + "]";
+                    SetFixtureSeed(replica_part.config, ReplicaSeed(config.seed, replica));
+                    replica_part.prefix = ReplicaString(config.replica_prefix, replica);
+                    if (!config.replica_broker.empty()) {
+                        replica_part.config.broker = ReplicaString(config.replica_broker, replica);
+                    }
+                }
+                replica_part.broker = replica_part.config.broker.empty() ? kuksa_address : replica_part.config.broker;
+                parts.push_back(std::move(replica_part));
+            }
+        }
+    }
 
-    runner.Stop();
+    // Outputs several parts publish on the same broker go through one merge
+    // per broker rather than being written by each
+    BrokerPool brokers(static_cast<size_t>(publish_channels));
+    std::map<std::string, std::unordered_map<std::string, size_t>> writers;  // Broker -> path -> parts
+    for (const auto& part : parts) {
+        auto& paths = writers[part.broker];
+        for (const auto& [signal, mapping] : part.config.mappings) {
+            ++paths[part.prefix + signal];
+        }
+        for (const auto& mapping : part.config.native_mappings) {
+            ++paths[part.prefix + mapping.signal];
+        }
+    }
+    std::map<std::string, std::unique_ptr<OutputMerge>> merges;
+    for (const auto& [broker, paths] : writers) {
+        for (const auto& [path, count] : paths) {
+            if (count < 2) {
+                continue;
+            }
+            auto& merge = merges[broker];
+            if (!merge) {
+                auto* connection = brokers.get(broker);
+                if (!connection) {
+                    return fail(StartupFailure{StartupError::BROKER_UNREACHABLE,
+                                               "Cannot connect to databroker " + broker, ""});
+                }
+                merge = std::make_unique<OutputMerge>(*connection, std::chrono::milliseconds(merge_quantum_ms),
+                                                      std::chrono::milliseconds(merge_hold_ms), metrics);
+            }
+            merge->add_path(path);
+            LOG(INFO) << "Merging " << path << " from " << count << " fixtures on " << broker;
+        }
+    }
+
+    // Each part has its own DAG owner thread, replicas share the pool's;
+    // parts on the same broker share its connection
+    std::unique_ptr<WorkerPool> pool;
+    std::vector<std::unique_ptr<FixtureRunner>> runners;
+    std::vector<FixtureRunner*> dedicated;
+    for (auto& part : parts) {
+        auto runner = std::make_unique<FixtureRunner>(brokers, kuksa_address, metrics);
+        runner->SetCapture(capture.get());
+        auto merge = merges.find(part.broker);
+        runner->SetMerge(merge != merges.end() ? merge->second.get() : nullptr);
+        if (part.pooled) {
+            if (!pool) {
+                pool = std::make_unique<WorkerPool>(static_cast<size_t>(workers));
+            }
+            runner->SetPathPrefix(part.prefix);
+            runner->SetPool(pool.get(), pool->add(runner.get()));
+        } else {
+            dedicated.push_back(runner.get());
+        }
+        const std::string name = part.config.name;
+        const size_t actuators = part.config.serves.size();
+        runner->Configure(std::move(part.config));
+        if (auto failure = runner->Start()) {
+            LOG(ERROR) << "Failed to start fixture runner for " << part.config_file;
+            return fail(*failure);
+        }
+        report.add_fixture(name, part.config_file, part.broker, actuators);
+        runners.push_back(std::move(runner));
+    }
+
+    std::string unready;
+    if (!brokers.start(std::chrono::seconds(10), &unready)) {
+        LOG(ERROR) << "Failed to connect to databroker";
+        return fail(StartupFailure{StartupError::BROKER_UNREACHABLE,
+                                   "Databroker " + unready + " not ready within 10s", ""});
+    }
+    for (auto& [broker, merge] : merges) {
+        merge->start();
+    }
+    if (pool) {
+        pool->start();
+    }
+    report.write(startup_report_file, std::nullopt);
+    LOG(INFO) << "Serving " << runners.size() << " fixture part(s) over " << brokers.size() << " broker connection(s)";
+
+    std::vector<std::thread> threads;
+    for (auto* runner : dedicated) {
+        threads.emplace_back([runner] { runner->Run(); });
+    }
+
+    int signal = 0;
+    sigwait(&shutdown_signals, &signal);
+    LOG(INFO) << "Received " << (signal == SIGINT ? "SIGINT" : "SIGTERM") << ", shutting down";
+
+    // Runners drain their queued outputs; the capture is sealed when its
+    // writer is destroyed, after the runners
+    for (auto& runner : runners) {
+        runner->Stop();
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (pool) {
+        pool->stop();
+    }
+    for (auto& [broker, merge] : merges) {
+        merge->stop();
+    }
+    brokers.stop();
     return 0;
 }
@@ -0,0 +1,200 @@
+#include "gorilla.hpp"
+
+#include <cstring>
+
+namespace {
+
+uint64_t DoubleBits(double v) {
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+double BitsDouble(uint64_t bits) {
+    double v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+uint64_t Mask(unsigned width) {
+    return width >= 64 ? ~0ULL : (1ULL << width) - 1;
+}
+
+// Delta-of-delta buckets: prefix, prefix length, value width, bias
+struct Bucket {
+    uint64_t prefix;
+    unsigned prefix_bits;
+    unsigned width;
+    int64_t bias;
+};
+
+constexpr Bucket kBuckets[] = {
+    {0b10, 2, 7, 63},
+    {0b110, 3, 9, 255},
+    {0b1110, 4, 12, 2047},
+    {0b11110, 5, 32, 2147483647LL},
+};
+
+}  // namespace
+
+void GorillaEncoder::WriteBits(uint64_t bits, unsigned width) {
+    while (width > 0) {
+        if (bit_ == 0) {
+            bytes_.push_back(0);
+        }
+        const unsigned take = width < 8 - bit_ ? width : 8 - bit_;
+        const uint64_t chunk = (bits >> (width - take)) & Mask(take);
+        bytes_.back() |= static_cast<uint8_t>(chunk << (8 - bit_ - take));
+        bit_ = (bit_ + take) % 8;
+        width -= take;
+    }
+}
+
+void GorillaEncoder::append(int64_t timestamp_us, double value) {
+    const uint64_t bits = DoubleBits(value);
+    if (count_++ == 0) {
+        first_timestamp_ = timestamp_us;
+        WriteBits(static_cast<uint64_t>(timestamp_us), 64);
+        WriteBits(bits, 64);
+        prev_timestamp_ = timestamp_us;
+        prev_bits_ = bits;
+        return;
+    }
+
+    const int64_t delta = timestamp_us - prev_timestamp_;
+    const int64_t dod = delta - prev_delta_;
+    prev_timestamp_ = timestamp_us;
+    prev_delta_ = delta;
+    if (dod == 0) {
+        WriteBits(0, 1);
+    } else {
+        bool written = false;
+        for (const auto& bucket : kBuckets) {
+            if (dod >= -bucket.bias && dod <= bucket.bias + 1) {
+                WriteBits(bucket.prefix, bucket.prefix_bits);
+                WriteBits(static_cast<uint64_t>(dod + bucket.bias), bucket.width);
+                written = true;
+                break;
+            }
+        }
+        if (!written) {
+            WriteBits(0b11111, 5);
+            WriteBits(static_cast<uint64_t>(dod), 64);
+        }
+    }
+
+    const uint64_t x = bits ^ prev_bits_;
+    prev_bits_ = bits;
+    if (x == 0) {
+        WriteBits(0, 1);
+        return;
+    }
+    unsigned leading = static_cast<unsigned>(__builtin_clzll(x));
+    const unsigned trailing = static_cast<unsigned>(__builtin_ctzll(x));
+    if (leading > 31) {
+        leading = 31;
+    }
+    if (have_window_ && leading >= prev_leading_ && trailing >= prev_trailing_) {
+        WriteBits(0b10, 2);
+        const unsigned width = 64 - prev_leading_ - prev_trailing_;
+        WriteBits(x >> prev_trailing_, width);
+        return;
+    }
+    const unsigned width = 64 - leading - trailing;
+    WriteBits(0b11, 2);
+    WriteBits(leading, 5);
+    WriteBits(width - 1, 6);
+    WriteBits(x >> trailing, width);
+    prev_leading_ = leading;
+    prev_trailing_ = trailing;
+    have_window_ = true;
+}
+
+GorillaDecoder::GorillaDecoder(const uint8_t* data, size_t size, size_t count)
+    : data_(data), size_(size), remaining_(count) {}
+
+bool GorillaDecoder::ReadBits(unsigned width, uint64_t& bits) {
+    if (pos_ + width > size_ * 8) {
+        return false;
+    }
+    bits = 0;
+    while (width > 0) {
+        const unsigned offset = pos_ % 8;
+        const unsigned take = width < 8 - offset ? width : 8 - offset;
+        const uint64_t byte = data_[pos_ / 8];
+        bits = (bits << take) | ((byte >> (8 - offset - take)) & Mask(take));
+        pos_ += take;
+        width -= take;
+    }
+    return true;
+}
+
+bool GorillaDecoder::next(int64_t& timestamp_us, double& value) {
+    if (remaining_ == 0) {
+        return false;
+    }
+    uint64_t bits;
+    if (read_++ == 0) {
+        uint64_t ts;
+        if (!ReadBits(64, ts) || !ReadBits(64, bits)) {
+            return false;
+        }
+        prev_timestamp_ = static_cast<int64_t>(ts);
+        prev_bits_ = bits;
+    } else {
+        // Count the leading ones of the timestamp prefix, up to 4
+        unsigned ones = 0;
+        uint64_t bit;
+        while (ones < 5) {
+            if (!ReadBits(1, bit)) {
+                return false;
+            }
+            if (bit == 0) {
+                break;
+            }
+            ++ones;
+        }
+        int64_t dod = 0;
+        if (ones == 5) {
+            if (!ReadBits(64, bits)) {
+                return false;
+            }
+            dod = static_cast<int64_t>(bits);
+        } else if (ones > 0) {
+            const Bucket& bucket = kBuckets[ones - 1];
+            if (!ReadBits(bucket.width, bits)) {
+                return false;
+            }
+            dod = static_cast<int64_t>(bits) - bucket.bias;
+        }
+        prev_delta_ += dod;
+        prev_timestamp_ += prev_delta_;
+
+        if (!ReadBits(1, bit)) {
+            return false;
+        }
+        if (bit == 1) {
+            if (!ReadBits(1, bit)) {
+                return false;
+            }
+            if (bit == 1) {
+                uint64_t leading;
+                uint64_t width;
+                if (!ReadBits(5, leading) || !ReadBits(6, width)) {
+                    return false;
+                }
+                prev_leading_ = static_cast<unsigned>(leading);
+                prev_trailing_ = 64 - prev_leading_ - static_cast<unsigned>(width + 1);
+            }
+            const unsigned width = 64 - prev_leading_ - prev_trailing_;
+            if (!ReadBits(width, bits)) {
+                return false;
+            }
+            prev_bits_ ^= bits << prev_trailing_;
+        }
+    }
+    --remaining_;
+    timestamp_us = prev_timestamp_;
+    value = BitsDouble(prev_bits_);
+    return true;
+}
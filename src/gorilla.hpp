@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Gorilla-style time series compression
+ *
+ * Timestamps (microseconds) are stored as delta-of-delta and values (doubles)
+ * as the XOR with the previous value, both with variable-length bit codes, as
+ * in "Gorilla: A Fast, Scalable, In-Memory Time Series Database" (VLDB 2015).
+ * Regularly published signals cost a few bits per point.
+ *
+ * A chunk starts with the first timestamp and value in full; the encoder and
+ * decoder must see the same points in the same order.
+ */
+class GorillaEncoder {
+public:
+    void append(int64_t timestamp_us, double value);
+
+    size_t count() const { return count_; }
+    int64_t first_timestamp() const { return first_timestamp_; }
+    const std::vector<uint8_t>& bytes() const { return bytes_; }
+
+private:
+    void WriteBits(uint64_t bits, unsigned width);
+
+    std::vector<uint8_t> bytes_;
+    unsigned bit_ = 0;  // Bits used in bytes_.back(), 0 = need a new byte
+    size_t count_ = 0;
+    int64_t first_timestamp_ = 0;
+    int64_t prev_timestamp_ = 0;
+    int64_t prev_delta_ = 0;
+    uint64_t prev_bits_ = 0;
+    unsigned prev_leading_ = 0;
+    unsigned prev_trailing_ = 0;
+    bool have_window_ = false;
+};
+
+class GorillaDecoder {
+public:
+    GorillaDecoder(const uint8_t* data, size_t size, size_t count);
+
+    // False once |count| points were read or the stream is corrupt
+    bool next(int64_t& timestamp_us, double& value);
+
+private:
+    bool ReadBits(unsigned width, uint64_t& bits);
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t remaining_;
+    size_t pos_ = 0;  // Bit position
+    size_t read_ = 0;
+    int64_t prev_timestamp_ = 0;
+    int64_t prev_delta_ = 0;
+    uint64_t prev_bits_ = 0;
+    unsigned prev_leading_ = 0;
+    unsigned prev_trailing_ = 0;
+};
@@ -0,0 +1,143 @@
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <glog/logging.h>
+
+namespace {
+
+size_t BucketFor(uint64_t v) {
+    if (v == 0) {
+        return 0;
+    }
+    const size_t bits = 64 - static_cast<size_t>(__builtin_clzll(v));
+    return std::min(bits, Histogram::kBuckets - 1);
+}
+
+size_t PowerOfTwoAtLeast(size_t n) {
+    size_t p = 1;
+    while (p < n) {
+        p *= 2;
+    }
+    return p;
+}
+
+}  // namespace
+
+size_t DefaultMetricShards() {
+    return PowerOfTwoAtLeast(std::max<size_t>(16, 2 * size_t{std::thread::hardware_concurrency()}));
+}
+
+void Histogram::observe(uint64_t v) {
+    Shard& shard = shards_[MetricThread() & mask_];
+    shard.sum.fetch_add(v, std::memory_order_relaxed);
+    shard.buckets[BucketFor(v)].fetch_add(1, std::memory_order_relaxed);
+
+    // Only the shard's own threads write its max, so this rarely retries
+    uint64_t prev = shard.max.load(std::memory_order_relaxed);
+    while (v > prev && !shard.max.compare_exchange_weak(prev, v, std::memory_order_relaxed)) {
+    }
+}
+
+nlohmann::json Histogram::to_json() const {
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+    uint64_t buckets[kBuckets] = {};
+    for (size_t s = 0; s <= mask_; ++s) {
+        const Shard& shard = shards_[s];
+        sum += shard.sum.load(std::memory_order_relaxed);
+        max = std::max(max, shard.max.load(std::memory_order_relaxed));
+        for (size_t i = 0; i < kBuckets; ++i) {
+            const uint64_t n = shard.buckets[i].load(std::memory_order_relaxed);
+            buckets[i] += n;
+            count += n;
+        }
+    }
+
+    nlohmann::json j;
+    j["count"] = count;
+    j["sum"] = sum;
+    j["max"] = max;
+
+    // Sparse list of [upper_bound, count] pairs
+    nlohmann::json sparse = nlohmann::json::array();
+    for (size_t i = 0; i < kBuckets; ++i) {
+        if (buckets[i] != 0) {
+            sparse.push_back({i == 0 ? 0 : (uint64_t{1} << i) - 1, buckets[i]});
+        }
+    }
+    j["buckets"] = std::move(sparse);
+    return j;
+}
+
+MetricsRegistry::MetricsRegistry(size_t shards) : shards_(PowerOfTwoAtLeast(shards)) {}
+
+Counter& MetricsRegistry::counter(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = counters_[name];
+    if (!slot) {
+        slot = std::make_unique<Counter>(shards_);
+    }
+    return *slot;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = histograms_[name];
+    if (!slot) {
+        slot = std::make_unique<Histogram>(shards_);
+    }
+    return *slot;
+}
+
+nlohmann::json MetricsRegistry::to_json() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    nlohmann::json j;
+    j["counters"] = nlohmann::json::object();
+    for (const auto& [name, counter] : counters_) {
+        j["counters"][name] = counter->value();
+    }
+    j["histograms"] = nlohmann::json::object();
+    for (const auto& [name, histogram] : histograms_) {
+        j["histograms"][name] = histogram->to_json();
+    }
+    return j;
+}
+
+MetricsReporter::MetricsReporter(const MetricsRegistry& registry, std::string path,
+                                 std::chrono::milliseconds interval)
+    : registry_(registry), path_(std::move(path)), interval_(interval) {
+    thread_ = std::thread([this] {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            cv_.wait_for(lock, interval_, [this] { return stopping_; });
+            WriteSnapshot();
+        }
+    });
+}
+
+MetricsReporter::~MetricsReporter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+void MetricsReporter::WriteSnapshot() {
+    const std::string tmp_path = path_ + ".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::trunc);
+        if (!out) {
+            LOG(WARNING) << "Cannot write metrics snapshot to " << tmp_path;
+            return;
+        }
+        out << registry_.to_json().dump(2) << "\n";
+    }
+    if (std::rename(tmp_path.c_str(), path_.c_str()) != 0) {
+        LOG(WARNING) << "Cannot replace metrics snapshot " << path_;
+    }
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+// Metrics are split into shards, each on its own cache lines, and summed
+// only when a snapshot is taken. Threads are numbered in the order they first
+// record and thread n records into shard n % shards, so no two threads share
+// a line until more threads have recorded than there are shards; from then on
+// every shards-th thread lands on the same one. The registry sizes the shard
+// count when it is created, see DefaultMetricShards().
+constexpr size_t kCacheLine = 64;
+
+// Number of the calling thread, assigned in order of first use
+inline size_t MetricThread() {
+    static std::atomic<size_t> next{0};
+    thread_local const size_t thread = next.fetch_add(1, std::memory_order_relaxed);
+    return thread;
+}
+
+// Twice the hardware threads rounded up to a power of two, at least 16: one
+// shard each for the worker pool, the DAG owners and the publishers
+size_t DefaultMetricShards();
+
+/**
+ * @brief Monotonic event counter, safe to bump from any thread
+ */
+class Counter {
+public:
+    // |shards| must be a power of two
+    explicit Counter(size_t shards) : mask_(shards - 1), shards_(new Shard[shards]) {}
+
+    void inc(uint64_t n = 1) {
+        shards_[MetricThread() & mask_].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const {
+        uint64_t total = 0;
+        for (size_t i = 0; i <= mask_; ++i) {
+            total += shards_[i].value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+private:
+    struct alignas(kCacheLine) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+    size_t mask_;
+    std::unique_ptr<Shard[]> shards_;
+};
+
+/**
+ * @brief Histogram with power-of-two buckets
+ *
+ * Bucket i counts observations in [2^(i-1), 2^i), bucket 0 counts zeros.
+ * Cheap enough to record on every DAG pass.
+ */
+class Histogram {
+public:
+    static constexpr size_t kBuckets = 48;
+
+    // |shards| must be a power of two
+    explicit Histogram(size_t shards) : mask_(shards - 1), shards_(new Shard[shards]) {}
+
+    void observe(uint64_t v);
+    nlohmann::json to_json() const;
+
+private:
+    // The count is the sum of the buckets
+    struct alignas(kCacheLine) Shard {
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> max{0};
+        std::atomic<uint64_t> buckets[kBuckets] = {};
+    };
+    size_t mask_;
+    std::unique_ptr<Shard[]> shards_;
+};
+
+/**
+ * @brief Process-wide set of named counters and histograms
+ *
+ * Metrics are created on first lookup and live as long as the registry, so
+ * callers cache the returned references and record without locking.
+ */
+class MetricsRegistry {
+public:
+    // |shards| per metric, rounded up to a power of two
+    explicit MetricsRegistry(size_t shards = DefaultMetricShards());
+
+    size_t shards() const { return shards_; }
+
+    Counter& counter(const std::string& name);
+    Histogram& histogram(const std::string& name);
+
+    nlohmann::json to_json() const;
+
+private:
+    size_t shards_;
+    mutable std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<Counter>> counters_;
+    std::map<std::string, std::unique_ptr<Histogram>> histograms_;
+};
+
+/**
+ * @brief Periodically writes a JSON snapshot of a registry to a file
+ *
+ * The file is replaced atomically (write + rename) so scrapers never see a
+ * partial snapshot.
+ */
+class MetricsReporter {
+public:
+    MetricsReporter(const MetricsRegistry& registry, std::string path,
+                    std::chrono::milliseconds interval = std::chrono::seconds(1));
+    ~MetricsReporter();
+
+    MetricsReporter(const MetricsReporter&) = delete;
+    MetricsReporter& operator=(const MetricsReporter&) = delete;
+
+private:
+    void WriteSnapshot();
+
+    const MetricsRegistry& registry_;
+    std::string path_;
+    std::chrono::milliseconds interval_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
@@ -0,0 +1,827 @@
+#include "native_graph.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
+#include <glog/logging.h>
+
+using vss::types::ValueType;
+
+namespace {
+
+struct KindName {
+    NativeKind kind;
+    const char* name;
+};
+
+constexpr KindName kKindNames[] = {
+    {NativeKind::COPY, "copy"},
+    {NativeKind::DELAYED, "delayed"},
+    {NativeKind::PLUGIN, "plugin"},
+    {NativeKind::LOWPASS, "lowpass"},
+    {NativeKind::MOVING_AVERAGE, "moving_average"},
+    {NativeKind::DERIVATIVE, "derivative"},
+    {NativeKind::SUSTAINED_CONDITION, "sustained_condition"},
+    {NativeKind::NOISE, "noise"},
+    {NativeKind::PLAYBACK, "playback"},
+};
+
+// Largest moving_average window; ring storage is allocated up front
+constexpr double kMaxWindow = 65536;
+
+// Parameters each kind accepts; anything else in the transform is rejected
+const std::vector<std::string>& AllowedParams(NativeKind kind) {
+    static const std::vector<std::string> copy = {"scale", "offset"};
+    static const std::vector<std::string> delayed = {"delay_ms"};
+    static const std::vector<std::string> plugin = {};
+    static const std::vector<std::string> lowpass = {"alpha", "rate_hz"};
+    static const std::vector<std::string> moving_average = {"window", "rate_hz"};
+    static const std::vector<std::string> derivative = {"rate_hz"};
+    static const std::vector<std::string> sustained = {"duration_ms"};
+    static const std::vector<std::string> noise = {"stddev", "rate_hz"};
+    static const std::vector<std::string> playback = {"rate_hz", "speed", "loop"};
+    switch (kind) {
+        case NativeKind::COPY: return copy;
+        case NativeKind::DELAYED: return delayed;
+        case NativeKind::PLUGIN: return plugin;
+        case NativeKind::LOWPASS: return lowpass;
+        case NativeKind::MOVING_AVERAGE: return moving_average;
+        case NativeKind::DERIVATIVE: return derivative;
+        case NativeKind::SUSTAINED_CONDITION: return sustained;
+        case NativeKind::NOISE: return noise;
+        case NativeKind::PLAYBACK: return playback;
+    }
+    return copy;
+}
+
+std::optional<std::string> CheckParams(const NativeMappingSpec& spec) {
+    const char* required = spec.kind == NativeKind::LOWPASS ? "alpha"
+                         : spec.kind == NativeKind::MOVING_AVERAGE ? "window"
+                         : spec.kind == NativeKind::SUSTAINED_CONDITION ? "duration_ms"
+                         : nullptr;
+    if (required && !spec.params.count(required)) {
+        return std::string("native transform '") + NativeKindName(spec.kind) + "' needs '" + required + "'";
+    }
+    const double alpha = spec.param("alpha", 0.5);
+    if (!(alpha > 0.0 && alpha <= 1.0)) {
+        return "alpha must be in (0, 1]";
+    }
+    const double window = spec.param("window", 1.0);
+    if (!(window >= 1.0 && window <= kMaxWindow) || window != std::floor(window)) {
+        return "window must be a whole number of samples between 1 and 65536";
+    }
+    for (const char* key : {"rate_hz", "stddev", "duration_ms", "delay_ms"}) {
+        if (!(spec.param(key, 0.0) >= 0.0)) {
+            return std::string(key) + " must not be negative";
+        }
+    }
+    return std::nullopt;
+}
+
+uint64_t Fnv1a(uint64_t hash, const std::string& text) {
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::string FormatDouble(double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.17g", v);
+    return buf;
+}
+
+template <typename T>
+T ClampRound(double v) {
+    if (std::isnan(v)) {
+        return T{};
+    }
+    const double r = std::round(v);
+    if (r <= static_cast<double>(std::numeric_limits<T>::lowest())) {
+        return std::numeric_limits<T>::lowest();
+    }
+    if (r >= static_cast<double>(std::numeric_limits<T>::max())) {
+        return std::numeric_limits<T>::max();
+    }
+    return static_cast<T>(r);
+}
+
+}  // namespace
+
+const char* NativeKindName(NativeKind kind) {
+    for (const auto& entry : kKindNames) {
+        if (entry.kind == kind) {
+            return entry.name;
+        }
+    }
+    return "unknown";
+}
+
+std::optional<NativeKind> NativeKindFromString(const std::string& name) {
+    for (const auto& entry : kKindNames) {
+        if (name == entry.name) {
+            return entry.kind;
+        }
+    }
+    return std::nullopt;
+}
+
+bool IsFilterKind(NativeKind kind) {
+    switch (kind) {
+        case NativeKind::LOWPASS:
+        case NativeKind::MOVING_AVERAGE:
+        case NativeKind::DERIVATIVE:
+        case NativeKind::SUSTAINED_CONDITION:
+        case NativeKind::NOISE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+uint64_t NativeRandomKey(const std::string& signal, uint64_t seed) {
+    return fixture_native::mix64(Fnv1a(14695981039346656037ULL, signal) ^ seed);
+}
+
+uint64_t NativeRandomKey(const NativeMappingSpec& spec) {
+    return NativeRandomKey(spec.signal, spec.seed);
+}
+
+namespace {
+
+std::optional<std::string> ParsePluginTransform(const YAML::Node& transform, const std::string& base_dir,
+                                                NativeMappingSpec& spec) {
+    spec.kind = NativeKind::PLUGIN;
+    if (!transform["fn"]) {
+        return "plugin transform needs 'fn'";
+    }
+
+    std::string library = transform["plugin"].as<std::string>();
+    if (library.find('/') != std::string::npos && library[0] != '/' && !base_dir.empty()) {
+        library = base_dir + "/" + library;
+    }
+
+    for (const auto& entry : transform) {
+        const std::string key = entry.first.as<std::string>();
+        if (key != "plugin" && key != "fn" && key != "params" && key != "seed") {
+            return "plugin transform has no field '" + key + "'";
+        }
+    }
+    if (transform["seed"]) {
+        spec.seed = transform["seed"].as<uint64_t>();
+        spec.own_seed = true;
+    }
+    if (transform["params"]) {
+        for (const auto& param : transform["params"]) {
+            spec.params[param.first.as<std::string>()] = param.second.as<double>();
+        }
+    }
+
+    std::string error;
+    spec.plugin = NativePlugin::Load(library, transform["fn"].as<std::string>(), error);
+    if (!spec.plugin) {
+        return error;
+    }
+    if (!IsNativeDatatype(spec.datatype)) {
+        return "plugin transforms need a boolean or numeric datatype";
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string> ParsePlaybackTransform(const YAML::Node& transform, const std::string& base_dir,
+                                                  NativeMappingSpec& spec) {
+    spec.kind = NativeKind::PLAYBACK;
+    if (!transform["file"] || !transform["column"]) {
+        return "playback needs 'file' and 'column'";
+    }
+
+    const auto& allowed = AllowedParams(spec.kind);
+    for (const auto& entry : transform) {
+        const std::string key = entry.first.as<std::string>();
+        if (key == "native" || key == "file" || key == "column" || key == "interpolate") {
+            continue;
+        }
+        if (std::find(allowed.begin(), allowed.end(), key) == allowed.end()) {
+            return "native transform 'playback' has no parameter '" + key + "'";
+        }
+        spec.params[key] = key == "loop" ? (entry.second.as<bool>() ? 1.0 : 0.0) : entry.second.as<double>();
+    }
+
+    const std::string interpolate = transform["interpolate"].as<std::string>("linear");
+    if (interpolate != "linear" && interpolate != "step") {
+        return "interpolate must be 'linear' or 'step'";
+    }
+    spec.params["linear"] = interpolate == "linear" ? 1.0 : 0.0;
+    if (!(spec.param("rate_hz", 10.0) > 0.0)) {
+        return "playback rate_hz must be positive";
+    }
+    if (!(spec.param("speed", 1.0) > 0.0)) {
+        return "playback speed must be positive";
+    }
+
+    std::string file = transform["file"].as<std::string>();
+    if (file[0] != '/' && !base_dir.empty()) {
+        file = base_dir + "/" + file;
+    }
+    std::string error;
+    spec.series = TimeSeriesFile::Open(file, error);
+    if (!spec.series) {
+        return error;
+    }
+    spec.column = transform["column"].as<std::string>();
+    if (!spec.series->column(spec.column)) {
+        return "time series " + file + " has no column '" + spec.column + "'";
+    }
+
+    if (!IsNativeDatatype(spec.datatype)) {
+        return "native transforms need a boolean or numeric datatype";
+    }
+    if (!spec.depends_on.empty()) {
+        return "playback takes no dependencies";
+    }
+    return std::nullopt;
+}
+
+}  // namespace
+
+std::optional<std::string> ParseNativeTransform(const YAML::Node& transform, const std::string& base_dir,
+                                                NativeMappingSpec& spec) {
+    if (transform["plugin"]) {
+        return ParsePluginTransform(transform, base_dir, spec);
+    }
+
+    const std::string kind_name = transform["native"].as<std::string>();
+    if (kind_name == "playback") {
+        return ParsePlaybackTransform(transform, base_dir, spec);
+    }
+    auto kind = NativeKindFromString(kind_name);
+    if (!kind || *kind == NativeKind::PLUGIN) {
+        return "unknown native transform '" + kind_name + "'";
+    }
+    spec.kind = *kind;
+
+    const auto& allowed = AllowedParams(spec.kind);
+    for (const auto& entry : transform) {
+        const std::string key = entry.first.as<std::string>();
+        if (key == "native") {
+            continue;
+        }
+        if (key == "seed" && spec.kind == NativeKind::NOISE) {
+            spec.seed = entry.second.as<uint64_t>();
+            spec.own_seed = true;
+            continue;
+        }
+        if (std::find(allowed.begin(), allowed.end(), key) == allowed.end()) {
+            return "native transform '" + kind_name + "' has no parameter '" + key + "'";
+        }
+        spec.params[key] = entry.second.as<double>();
+    }
+
+    if (!IsNativeDatatype(spec.datatype)) {
+        return "native transforms need a boolean or numeric datatype";
+    }
+    if (spec.depends_on.size() != 1) {
+        return "native transform '" + kind_name + "' takes exactly one dependency";
+    }
+    return CheckParams(spec);
+}
+
+uint64_t NativeGraphSpec::fingerprint() const {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const auto& input : inputs) {
+        hash = Fnv1a(hash, "in:" + input + ";");
+    }
+    for (const auto& node : nodes) {
+        std::string text = "node:" + node.mapping.signal + ":" + NativeKindName(node.mapping.kind) +
+                           ":" + std::to_string(static_cast<int>(node.mapping.datatype));
+        for (uint32_t slot : node.input_slots) {
+            text += ":" + std::to_string(slot);
+        }
+        for (const auto& [key, value] : node.mapping.params) {
+            text += ":" + key + "=" + FormatDouble(value);
+        }
+        if (node.mapping.plugin) {
+            text += ":" + node.mapping.plugin->library() + "#" + node.mapping.plugin->fn();
+        }
+        if (node.mapping.series) {
+            text += ":" + node.mapping.series->path() + "#" + node.mapping.column;
+        }
+        if (node.mapping.own_seed) {
+            text += ":seed=" + std::to_string(node.mapping.seed);
+        }
+        hash = Fnv1a(hash, text + ";");
+    }
+    return hash;
+}
+
+std::optional<std::string> BuildNativeGraphSpec(const std::vector<NativeMappingSpec>& mappings,
+                                                const std::vector<std::string>& serves,
+                                                NativeGraphSpec& spec) {
+    spec = NativeGraphSpec{};
+    const std::unordered_set<std::string> served(serves.begin(), serves.end());
+
+    std::unordered_map<std::string, size_t> by_signal;
+    for (size_t i = 0; i < mappings.size(); ++i) {
+        by_signal[mappings[i].signal] = i;
+    }
+
+    // A served actuator mirrored by a native mapping shares its datatype
+    auto input_type = [&](const std::string& actuator) {
+        auto it = by_signal.find(actuator);
+        return it != by_signal.end() ? mappings[it->second].datatype : ValueType::DOUBLE;
+    };
+
+    // Kahn's algorithm over node -> node edges; served actuators are roots
+    std::vector<size_t> pending_deps(mappings.size(), 0);
+    std::vector<std::vector<size_t>> dependents(mappings.size());
+    std::unordered_map<std::string, uint32_t> input_slot;
+    for (size_t i = 0; i < mappings.size(); ++i) {
+        for (const auto& dep : mappings[i].depends_on) {
+            if (served.count(dep)) {
+                if (!input_slot.count(dep)) {
+                    input_slot[dep] = static_cast<uint32_t>(spec.inputs.size());
+                    spec.inputs.push_back(dep);
+                    spec.input_types.push_back(input_type(dep));
+                }
+                continue;
+            }
+            auto it = by_signal.find(dep);
+            if (it == by_signal.end()) {
+                return "native mapping " + mappings[i].signal + " depends on " + dep +
+                       ", which is neither served nor a native mapping";
+            }
+            dependents[it->second].push_back(i);
+            ++pending_deps[i];
+        }
+    }
+
+    std::vector<size_t> order;
+    for (size_t i = 0; i < mappings.size(); ++i) {
+        if (pending_deps[i] == 0) {
+            order.push_back(i);
+        }
+    }
+    for (size_t head = 0; head < order.size(); ++head) {
+        for (size_t dependent : dependents[order[head]]) {
+            if (--pending_deps[dependent] == 0) {
+                order.push_back(dependent);
+            }
+        }
+    }
+    if (order.size() != mappings.size()) {
+        return "native mappings contain a dependency cycle";
+    }
+
+    std::vector<uint32_t> node_index(mappings.size());
+    for (size_t k = 0; k < order.size(); ++k) {
+        node_index[order[k]] = static_cast<uint32_t>(k);
+    }
+
+    for (size_t idx : order) {
+        NativeGraphSpec::Node node;
+        node.mapping = mappings[idx];
+        for (const auto& dep : node.mapping.depends_on) {
+            auto slot_it = input_slot.find(dep);
+            if (slot_it != input_slot.end()) {
+                node.input_slots.push_back(slot_it->second);
+            } else {
+                node.input_slots.push_back(spec.node_slot(node_index[by_signal[dep]]));
+            }
+        }
+        spec.nodes.push_back(std::move(node));
+    }
+    return std::nullopt;
+}
+
+NativeGraph::NativeGraph(const NativeGraphSpec& spec)
+    : values_(spec.slot_count(), 0.0), dirty_(spec.slot_count(), 0) {
+    for (ValueType type : spec.input_types) {
+        slot_types_.push_back(PluginTypeFor(type));
+    }
+    for (const auto& node : spec.nodes) {
+        slot_types_.push_back(PluginTypeFor(node.mapping.datatype));
+    }
+
+    // Depth of every slot: inputs are 0, a node is one deeper than its deepest input
+    std::vector<size_t> depth(spec.slot_count(), 0);
+
+    nodes_.reserve(spec.nodes.size());
+    for (size_t k = 0; k < spec.nodes.size(); ++k) {
+        const auto& mapping = spec.nodes[k].mapping;
+        Node node;
+        node.kind = mapping.kind;
+        node.inputs = spec.nodes[k].input_slots;
+        node.slot = spec.node_slot(k);
+        node.scale = mapping.param("scale", 1.0);
+        node.offset = mapping.param("offset", 0.0);
+        node.delay = std::chrono::duration_cast<fixture_native::Clock::duration>(
+            std::chrono::duration<double, std::milli>(mapping.param("delay_ms", 0.0)));
+        if (mapping.plugin) {
+            std::vector<fixture_param> params;
+            for (const auto& [key, value] : mapping.params) {
+                params.push_back(fixture_param{key.c_str(), value});
+            }
+            // The mapping's random stream, as an integer exact in a double
+            if (!mapping.params.count("seed")) {
+                params.push_back(fixture_param{"seed", static_cast<double>(NativeRandomKey(mapping) >> 11)});
+            }
+            node.plugin = mapping.plugin;
+            node.plugin_state = node.plugin->CreateState(params);
+            node.output_type = PluginTypeFor(mapping.datatype);
+            node.args.resize(node.inputs.size());
+            node.changed.resize(node.inputs.size());
+        }
+        if (mapping.series) {
+            node.cursor.emplace(mapping.series, *mapping.series->column(mapping.column));
+            node.speed = mapping.param("speed", 1.0);
+            node.period_s = 1.0 / mapping.param("rate_hz", 10.0);
+            node.loop = mapping.param("loop", 0.0) != 0.0;
+            node.linear = mapping.param("linear", 1.0) != 0.0;
+        }
+
+        size_t level = 0;
+        for (uint32_t in : node.inputs) {
+            level = std::max(level, depth[in]);
+        }
+        depth[node.slot] = level + 1;
+        if (levels_.size() <= level) {
+            levels_.resize(level + 1);
+        }
+        if (IsFilterKind(mapping.kind)) {
+            AddLane(levels_[level], mapping, k, node.inputs[0], node.slot);
+        } else {
+            levels_[level].nodes.push_back(k);
+        }
+        nodes_.push_back(std::move(node));
+    }
+}
+
+void NativeGraph::AddLane(Level& level, const NativeMappingSpec& mapping, size_t k, uint32_t in, uint32_t slot) {
+    auto it = std::find_if(level.banks.begin(), level.banks.end(),
+                           [&](const Bank& bank) { return bank.kind == mapping.kind; });
+    if (it == level.banks.end()) {
+        level.banks.push_back(Bank{});
+        it = std::prev(level.banks.end());
+        it->kind = mapping.kind;
+    }
+    Bank& bank = *it;
+
+    const double rate_hz = mapping.param("rate_hz", 0.0);
+    bank.node_ids.push_back(static_cast<uint32_t>(k));
+    bank.in_slots.push_back(in);
+    bank.out_slots.push_back(slot);
+    bank.x.push_back(0.0);
+    bank.y.push_back(0.0);
+    bank.active.push_back(0);
+    bank.period_s.push_back(rate_hz > 0.0 ? 1.0 / rate_hz : 0.0);
+    bank.next_sample_s.push_back(fixture_native::kNever);
+    bank.primed.push_back(0);
+
+    switch (mapping.kind) {
+        case NativeKind::LOWPASS:
+            bank.param.push_back(mapping.param("alpha", 0.5));
+            break;
+        case NativeKind::DERIVATIVE:
+            bank.param.push_back(0.0);
+            bank.prev_x.push_back(0.0);
+            bank.prev_t.push_back(0.0);
+            break;
+        case NativeKind::NOISE:
+            bank.param.push_back(mapping.param("stddev", 1.0));
+            bank.key.push_back(NativeRandomKey(mapping));
+            bank.counter.push_back(0);
+            break;
+        case NativeKind::SUSTAINED_CONDITION:
+            bank.param.push_back(mapping.param("duration_ms", 0.0) / 1000.0);
+            bank.since_s.push_back(-1.0);
+            break;
+        case NativeKind::MOVING_AVERAGE: {
+            const auto window = static_cast<uint32_t>(mapping.param("window", 1.0));
+            bank.param.push_back(0.0);
+            bank.ring_offset.push_back(static_cast<uint32_t>(bank.ring.size()));
+            bank.ring.resize(bank.ring.size() + window, 0.0);
+            bank.window.push_back(window);
+            bank.head.push_back(0);
+            bank.count.push_back(0);
+            bank.sum.push_back(0.0);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+NativeGraph::~NativeGraph() {
+    for (auto& node : nodes_) {
+        if (node.plugin) {
+            node.plugin->DestroyState(node.plugin_state);
+        }
+    }
+}
+
+void NativeGraph::set_input(uint32_t slot, double value) {
+    values_[slot] = value;
+    dirty_[slot] = 1;
+}
+
+void NativeGraph::evaluate(fixture_native::Clock::time_point now, std::vector<NativeOutput>& outputs) {
+    const double now_s = fixture_native::seconds(now);
+    for (auto& level : levels_) {
+        for (size_t k : level.nodes) {
+            Node& node = nodes_[k];
+            if (EvaluateNode(node, now)) {
+                dirty_[node.slot] = 1;
+                outputs.push_back(NativeOutput{static_cast<uint32_t>(k), values_[node.slot]});
+            }
+        }
+        for (auto& bank : level.banks) {
+            RunBank(bank, now_s, outputs);
+        }
+    }
+    std::fill(dirty_.begin(), dirty_.end(), 0);
+}
+
+bool NativeGraph::EvaluateNode(Node& node, fixture_native::Clock::time_point now) {
+    switch (node.kind) {
+        case NativeKind::COPY: {
+            const uint32_t in = node.inputs[0];
+            if (dirty_[in]) {
+                values_[node.slot] = fixture_native::copy_step(values_[in], node.scale, node.offset);
+                return true;
+            }
+            return false;
+        }
+        case NativeKind::DELAYED: {
+            const uint32_t in = node.inputs[0];
+            if (dirty_[in]) {
+                fixture_native::delayed_arm(node.delayed, values_[in], now, node.delay);
+            }
+            return fixture_native::delayed_fire(node.delayed, now, values_[node.slot]);
+        }
+        case NativeKind::PLUGIN: {
+            bool changed = false;
+            for (uint32_t slot : node.inputs) {
+                changed = changed || dirty_[slot];
+            }
+            const bool due = node.call_pending || (node.next_call && now >= *node.next_call);
+            return (changed || due) && CallPlugin(node, now);
+        }
+        case NativeKind::PLAYBACK:
+            return Playback(node, fixture_native::seconds(now));
+        default:
+            return false;  // Filter kinds run in banks
+    }
+}
+
+void NativeGraph::RunBank(Bank& bank, double now_s, std::vector<NativeOutput>& outputs) {
+    const size_t n = bank.node_ids.size();
+
+    // Gather inputs and decide which lanes take a sample
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t in = bank.in_slots[i];
+        bank.x[i] = values_[in];
+        bank.active[i] = fixture_native::sample_active(dirty_[in] != 0, now_s, bank.period_s[i],
+                                                       bank.next_sample_s[i]);
+    }
+
+    switch (bank.kind) {
+        case NativeKind::LOWPASS:
+            fixture_native::lowpass_bank(n, bank.x.data(), bank.param.data(), bank.active.data(),
+                                         bank.primed.data(), bank.y.data());
+            break;
+        case NativeKind::DERIVATIVE:
+            fixture_native::derivative_bank(n, bank.x.data(), bank.active.data(), now_s, bank.prev_x.data(),
+                                            bank.prev_t.data(), bank.primed.data(), bank.y.data());
+            break;
+        case NativeKind::NOISE:
+            fixture_native::noise_bank(n, bank.x.data(), bank.param.data(), bank.key.data(), bank.active.data(),
+                                       bank.counter.data(), bank.y.data());
+            break;
+        case NativeKind::MOVING_AVERAGE:
+            for (size_t i = 0; i < n; ++i) {
+                if (bank.active[i]) {
+                    bank.y[i] = fixture_native::moving_average_step(&bank.ring[bank.ring_offset[i]], bank.window[i],
+                                                                    bank.head[i], bank.count[i], bank.sum[i], bank.x[i]);
+                }
+            }
+            break;
+        case NativeKind::SUSTAINED_CONDITION:
+            // Time-driven: every lane is checked each pass, output on input or edge
+            for (size_t i = 0; i < n; ++i) {
+                const double next = fixture_native::sustained_step(bank.x[i] != 0.0, now_s, bank.param[i],
+                                                                   bank.since_s[i]);
+                bank.active[i] = bank.active[i] | (next != bank.y[i]);
+                bank.y[i] = next;
+            }
+            break;
+        default:
+            break;
+    }
+
+    // Scatter the lanes that produced a value
+    for (size_t i = 0; i < n; ++i) {
+        if (bank.active[i]) {
+            const uint32_t slot = bank.out_slots[i];
+            values_[slot] = bank.y[i];
+            dirty_[slot] = 1;
+            outputs.push_back(NativeOutput{bank.node_ids[i], bank.y[i]});
+        }
+    }
+}
+
+bool NativeGraph::CallPlugin(Node& node, fixture_native::Clock::time_point now) {
+    for (size_t i = 0; i < node.inputs.size(); ++i) {
+        const uint32_t slot = node.inputs[i];
+        node.args[i] = PluginValueFromNative(values_[slot], slot_types_[slot]);
+        node.changed[i] = dirty_[slot];
+    }
+
+    fixture_value output = PluginValueFromNative(values_[node.slot], node.output_type);
+    fixture_call call{};
+    call.abi_version = FIXTURE_PLUGIN_ABI_VERSION;
+    call.inputs = node.args.data();
+    call.changed = node.changed.data();
+    call.input_count = node.args.size();
+    call.output = &output;
+    call.now_s = fixture_native::seconds(now);
+    call.state = node.plugin_state;
+
+    const int result = node.plugin->Call(call);
+
+    node.call_pending = false;
+    node.next_call.reset();
+    if (call.next_call_s > 0.0) {
+        node.next_call = fixture_native::from_seconds(call.next_call_s);
+    }
+
+    if (result < 0) {
+        LOG(WARNING) << "Plugin transform " << node.plugin->fn() << " failed with " << result;
+        return false;
+    }
+    if (result == FIXTURE_NO_OUTPUT) {
+        return false;
+    }
+    output.type = node.output_type;  // The plugin may not change the type
+    values_[node.slot] = NativeValueFromPlugin(output);
+    return true;
+}
+
+bool NativeGraph::Playback(Node& node, double now_s) {
+    // Playback starts with the first evaluation and then follows rate_hz
+    const bool first = !node.started;
+    if (first) {
+        node.started = true;
+        node.start_s = now_s;
+    }
+    if (!fixture_native::sample_active(first, now_s, node.period_s, node.next_sample_s)) {
+        return false;
+    }
+
+    const TimeSeriesFile& series = *node.cursor->file();
+    const double duration = series.end_time() - series.start_time();
+    double t = (now_s - node.start_s) * node.speed;
+    if (t > duration) {
+        if (node.loop && duration > 0.0) {
+            const auto laps = static_cast<uint64_t>(t / duration);
+            t -= static_cast<double>(laps) * duration;
+            if (laps != node.laps) {
+                node.laps = laps;
+                node.cursor->rewind();
+            }
+        } else {
+            t = duration;
+            node.next_sample_s = fixture_native::kNever;  // Hold the last value
+        }
+    }
+    values_[node.slot] = node.cursor->sample(series.start_time() + t, node.linear);
+    return true;
+}
+
+std::optional<fixture_native::Clock::time_point> NativeGraph::next_deadline() const {
+    std::optional<fixture_native::Clock::time_point> deadline;
+    auto consider = [&](fixture_native::Clock::time_point t) {
+        if (!deadline || t < *deadline) {
+            deadline = t;
+        }
+    };
+    for (const auto& node : nodes_) {
+        if (node.kind == NativeKind::DELAYED && node.delayed.armed) {
+            consider(node.delayed.due);
+        } else if (node.kind == NativeKind::PLUGIN) {
+            if (node.call_pending) {
+                consider(fixture_native::Clock::time_point{});
+            } else if (node.next_call) {
+                consider(*node.next_call);
+            }
+        } else if (node.kind == NativeKind::PLAYBACK) {
+            if (!node.started) {
+                consider(fixture_native::Clock::time_point{});
+            } else if (node.next_sample_s != fixture_native::kNever) {
+                consider(fixture_native::from_seconds(node.next_sample_s));
+            }
+        }
+    }
+    for (const auto& level : levels_) {
+        for (const auto& bank : level.banks) {
+            for (size_t i = 0; i < bank.node_ids.size(); ++i) {
+                if (bank.next_sample_s[i] != fixture_native::kNever) {
+                    consider(fixture_native::from_seconds(bank.next_sample_s[i]));
+                }
+                if (bank.kind == NativeKind::SUSTAINED_CONDITION && bank.since_s[i] >= 0.0 && bank.y[i] == 0.0) {
+                    consider(fixture_native::from_seconds(bank.since_s[i] + bank.param[i]));
+                }
+            }
+        }
+    }
+    return deadline;
+}
+
+namespace {
+
+std::vector<const CompiledNativeProgram*>& CompiledPrograms() {
+    static std::vector<const CompiledNativeProgram*> programs;
+    return programs;
+}
+
+}  // namespace
+
+CompiledNativeProgram::CompiledNativeProgram(const char* fixture_name, uint64_t fingerprint, Factory factory)
+    : fixture_name_(fixture_name), fingerprint_(fingerprint), factory_(factory) {
+    CompiledPrograms().push_back(this);
+}
+
+const CompiledNativeProgram* CompiledNativeProgram::find(uint64_t fingerprint) {
+    for (const auto* program : CompiledPrograms()) {
+        if (program->fingerprint() == fingerprint) {
+            return program;
+        }
+    }
+    return nullptr;
+}
+
+std::unique_ptr<NativeProgram> CreateNativeProgram(const NativeGraphSpec& spec, uint64_t seed, bool* compiled) {
+    if (const auto* program = CompiledNativeProgram::find(spec.fingerprint())) {
+        if (compiled) {
+            *compiled = true;
+        }
+        return program->create(seed);
+    }
+    if (compiled) {
+        *compiled = false;
+    }
+    return std::make_unique<NativeGraph>(spec);
+}
+
+bool IsNativeDatatype(ValueType type) {
+    switch (type) {
+        case ValueType::BOOL:
+        case ValueType::INT8:
+        case ValueType::INT16:
+        case ValueType::INT32:
+        case ValueType::INT64:
+        case ValueType::UINT8:
+        case ValueType::UINT16:
+        case ValueType::UINT32:
+        case ValueType::UINT64:
+        case ValueType::FLOAT:
+        case ValueType::DOUBLE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::optional<double> NativeValueFromVss(const vss::types::Value& value) {
+    return std::visit([](const auto& v) -> std::optional<double> {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, bool>) {
+            return v ? 1.0 : 0.0;
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            return static_cast<double>(v);
+        } else {
+            return std::nullopt;
+        }
+    }, value);
+}
+
+vss::types::Value VssValueFromNative(double value, ValueType type) {
+    switch (type) {
+        case ValueType::BOOL: return value != 0.0;
+        case ValueType::INT8: return ClampRound<int8_t>(value);
+        case ValueType::INT16: return ClampRound<int16_t>(value);
+        case ValueType::INT32: return ClampRound<int32_t>(value);
+        case ValueType::INT64: return ClampRound<int64_t>(value);
+        case ValueType::UINT8: return ClampRound<uint8_t>(value);
+        case ValueType::UINT16: return ClampRound<uint16_t>(value);
+        case ValueType::UINT32: return ClampRound<uint32_t>(value);
+        case ValueType::UINT64: return ClampRound<uint64_t>(value);
+        case ValueType::FLOAT: return static_cast<float>(value);
+        default: return value;
+    }
+}
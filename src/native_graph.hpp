@@ -0,0 +1,273 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+#include <vss/types/value.hpp>
+#include "native_kernels.hpp"
+#include "native_plugin.hpp"
+#include "time_series.hpp"
+
+/**
+ * Native mappings
+ *
+ * Mappings declared with `transform: {native: <kind>, ...}` are evaluated in
+ * C++ instead of Lua. They are wired into a small graph fed by served
+ * actuator commands, and can be evaluated either by the NativeGraph
+ * interpreter or by a program generated with fixture-codegen.
+ */
+
+enum class NativeKind {
+    COPY,                 // y = x * scale + offset
+    DELAYED,              // y = x after delay_ms
+    PLUGIN,               // y = fn(deps...) from a plugin library, see fixture_plugin.h
+    LOWPASS,              // y += alpha * (x - y)
+    MOVING_AVERAGE,       // y = mean of the last window samples
+    DERIVATIVE,           // y = dx/dt per second
+    SUSTAINED_CONDITION,  // y = x has been non-zero for duration_ms
+    NOISE,                // y = x + gaussian noise with stddev
+    PLAYBACK,             // y = column of a recorded time series, see time_series.hpp
+};
+
+const char* NativeKindName(NativeKind kind);
+std::optional<NativeKind> NativeKindFromString(const std::string& name);
+
+// Filter kinds keep per-signal state and are evaluated in banks, see NativeGraph
+bool IsFilterKind(NativeKind kind);
+
+/**
+ * @brief One mapping with a native transform, as declared in the fixture YAML
+ */
+struct NativeMappingSpec {
+    std::string signal;
+    NativeKind kind = NativeKind::COPY;
+    std::vector<std::string> depends_on;
+    vss::types::ValueType datatype = vss::types::ValueType::UNSPECIFIED;
+    std::map<std::string, double> params;  // Kind-specific numeric parameters
+    std::shared_ptr<NativePlugin> plugin;   // PLUGIN only
+    std::shared_ptr<const TimeSeriesFile> series;  // PLAYBACK only
+    std::string column;                            // PLAYBACK only
+    uint64_t seed = 0;       // Random stream seed (NOISE, PLUGIN); the fixture's unless set here
+    bool own_seed = false;   // The transform sets 'seed'
+
+    double param(const std::string& key, double fallback) const {
+        auto it = params.find(key);
+        return it != params.end() ? it->second : fallback;
+    }
+};
+
+// Key of a mapping's random sequence: its signal path mixed with its seed.
+// Seed 0 keeps the sequences of fixtures written before seeds existed.
+uint64_t NativeRandomKey(const std::string& signal, uint64_t seed);
+uint64_t NativeRandomKey(const NativeMappingSpec& spec);
+
+/**
+ * @brief Parse a native or plugin transform node into |spec|
+ *
+ * Plugin libraries are loaded here; relative library paths containing a '/'
+ * are resolved against |base_dir| (the fixture file's directory).
+ *
+ * @return error message, or nullopt on success
+ */
+std::optional<std::string> ParseNativeTransform(const YAML::Node& transform, const std::string& base_dir,
+                                                NativeMappingSpec& spec);
+
+/**
+ * @brief Native mappings resolved into an evaluation order
+ *
+ * Values live in slots: [0, inputs.size()) hold served actuator commands,
+ * slot inputs.size() + k holds the output of node k.
+ */
+struct NativeGraphSpec {
+    struct Node {
+        NativeMappingSpec mapping;
+        std::vector<uint32_t> input_slots;
+    };
+
+    std::vector<std::string> inputs;  // Served actuators read by native nodes
+    std::vector<vss::types::ValueType> input_types;  // Parallel to inputs, DOUBLE if unknown
+    std::vector<Node> nodes;          // Topologically sorted
+
+    uint32_t node_slot(size_t node) const {
+        return static_cast<uint32_t>(inputs.size() + node);
+    }
+    size_t slot_count() const { return inputs.size() + nodes.size(); }
+
+    // Stable hash of the wiring and parameters; ties generated code to its
+    // YAML. Seeds that follow the fixture's are left out, so reseeding a
+    // fixture keeps its compiled program, which takes the seed at create().
+    uint64_t fingerprint() const;
+};
+
+/**
+ * @brief Resolve dependencies and sort native mappings
+ *
+ * A dependency naming a served actuator reads its command (the .target
+ * value); any other dependency must name another native mapping.
+ *
+ * @return error message, or nullopt on success
+ */
+std::optional<std::string> BuildNativeGraphSpec(const std::vector<NativeMappingSpec>& mappings,
+                                                const std::vector<std::string>& serves,
+                                                NativeGraphSpec& spec);
+
+struct NativeOutput {
+    uint32_t node;
+    double value;
+};
+
+/**
+ * @brief Evaluation engine for a NativeGraphSpec
+ */
+class NativeProgram {
+public:
+    virtual ~NativeProgram() = default;
+
+    // Store a new command in an input slot; consumed by the next evaluate()
+    virtual void set_input(uint32_t slot, double value) = 0;
+
+    // Run nodes whose inputs changed or whose timers are due, appending their outputs
+    virtual void evaluate(fixture_native::Clock::time_point now, std::vector<NativeOutput>& outputs) = 0;
+
+    // Earliest pending timer, if any
+    virtual std::optional<fixture_native::Clock::time_point> next_deadline() const = 0;
+};
+
+/**
+ * @brief Interpreter for native graphs loaded from YAML at runtime
+ *
+ * Nodes are grouped by depth; a level only reads slots of earlier levels.
+ * Within a level, filter nodes of the same kind form a bank whose state lives
+ * in contiguous per-signal arrays, so one kernel call (see native_kernels.hpp)
+ * updates every signal of the bank.
+ */
+class NativeGraph final : public NativeProgram {
+public:
+    explicit NativeGraph(const NativeGraphSpec& spec);
+    ~NativeGraph() override;
+
+    NativeGraph(const NativeGraph&) = delete;
+    NativeGraph& operator=(const NativeGraph&) = delete;
+
+    void set_input(uint32_t slot, double value) override;
+    void evaluate(fixture_native::Clock::time_point now, std::vector<NativeOutput>& outputs) override;
+    std::optional<fixture_native::Clock::time_point> next_deadline() const override;
+
+private:
+    struct Node {
+        NativeKind kind;
+        std::vector<uint32_t> inputs;
+        uint32_t slot;
+        double scale = 1.0;
+        double offset = 0.0;
+        fixture_native::Clock::duration delay{};
+        fixture_native::DelayedState delayed;
+
+        // PLUGIN
+        std::shared_ptr<NativePlugin> plugin;
+        void* plugin_state = nullptr;
+        fixture_type output_type = FIXTURE_TYPE_DOUBLE;
+        std::vector<fixture_value> args;
+        std::vector<uint8_t> changed;
+        bool call_pending = true;  // First evaluation always calls the plugin
+        std::optional<fixture_native::Clock::time_point> next_call;
+
+        // PLAYBACK
+        std::optional<TimeSeriesCursor> cursor;
+        double speed = 1.0;
+        double period_s = 0.0;
+        bool loop = false;
+        bool linear = true;
+        bool started = false;
+        double start_s = 0.0;
+        double next_sample_s = fixture_native::kNever;
+        uint64_t laps = 0;
+    };
+
+    // One lane per filter node; arrays are indexed by lane
+    struct Bank {
+        NativeKind kind;
+        std::vector<uint32_t> node_ids;
+        std::vector<uint32_t> in_slots;
+        std::vector<uint32_t> out_slots;
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<uint8_t> active;
+        std::vector<double> param;          // alpha, stddev or duration in seconds
+        std::vector<double> period_s;       // 1 / rate_hz, 0 = on input change only
+        std::vector<double> next_sample_s;
+        std::vector<uint8_t> primed;
+
+        std::vector<double> prev_x;         // DERIVATIVE
+        std::vector<double> prev_t;
+        std::vector<uint64_t> key;          // NOISE
+        std::vector<uint64_t> counter;
+        std::vector<double> since_s;        // SUSTAINED_CONDITION
+        std::vector<double> ring;           // MOVING_AVERAGE, window samples per lane
+        std::vector<uint32_t> ring_offset;
+        std::vector<uint32_t> window;
+        std::vector<uint32_t> head;
+        std::vector<uint32_t> count;
+        std::vector<double> sum;            // Running total of the ring
+    };
+
+    struct Level {
+        std::vector<size_t> nodes;  // Non-filter nodes, in topological order
+        std::vector<Bank> banks;    // One per filter kind present at this level
+    };
+
+    void AddLane(Level& level, const NativeMappingSpec& mapping, size_t k, uint32_t in, uint32_t slot);
+    bool EvaluateNode(Node& node, fixture_native::Clock::time_point now);
+    void RunBank(Bank& bank, double now_s, std::vector<NativeOutput>& outputs);
+    bool CallPlugin(Node& node, fixture_native::Clock::time_point now);
+    bool Playback(Node& node, double now_s);
+
+    std::vector<Node> nodes_;
+    std::vector<Level> levels_;
+    std::vector<fixture_type> slot_types_;
+    std::vector<double> values_;
+    std::vector<uint8_t> dirty_;
+};
+
+/**
+ * @brief Registration of a program generated by fixture-codegen
+ *
+ * Generated sources define one static instance; the runner picks it up when
+ * the fingerprint of the loaded YAML matches. create() takes the fixture's
+ * seed, for the mappings without a seed of their own.
+ */
+class CompiledNativeProgram {
+public:
+    using Factory = std::unique_ptr<NativeProgram> (*)(uint64_t seed);
+
+    CompiledNativeProgram(const char* fixture_name, uint64_t fingerprint, Factory factory);
+
+    const char* fixture_name() const { return fixture_name_; }
+    uint64_t fingerprint() const { return fingerprint_; }
+    std::unique_ptr<NativeProgram> create(uint64_t seed) const { return factory_(seed); }
+
+    static const CompiledNativeProgram* find(uint64_t fingerprint);
+
+private:
+    const char* fixture_name_;
+    uint64_t fingerprint_;
+    Factory factory_;
+};
+
+/**
+ * @brief Compiled program for |spec| if one is linked in, else the interpreter
+ *
+ * |seed| is the fixture seed |spec| was built with.
+ */
+std::unique_ptr<NativeProgram> CreateNativeProgram(const NativeGraphSpec& spec, uint64_t seed,
+                                                   bool* compiled = nullptr);
+
+// Native values are doubles; booleans map to 0/1
+bool IsNativeDatatype(vss::types::ValueType type);
+std::optional<double> NativeValueFromVss(const vss::types::Value& value);
+vss::types::Value VssValueFromNative(double value, vss::types::ValueType type);
@@ -0,0 +1,197 @@
+#pragma once
+
+/**
+ * Native mapping kernels
+ *
+ * Step functions shared by the native graph interpreter (native_graph.cpp)
+ * and by code emitted from fixture-codegen, so both evaluation engines have
+ * identical semantics. Values are doubles; booleans are 0/1.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace fixture_native {
+
+using Clock = std::chrono::steady_clock;
+
+inline double seconds(Clock::time_point t) {
+    return std::chrono::duration<double>(t.time_since_epoch()).count();
+}
+
+inline Clock::time_point from_seconds(double s) {
+    return Clock::time_point(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(s)));
+}
+
+// copy: y = x * scale + offset
+inline double copy_step(double x, double scale, double offset) {
+    return x * scale + offset;
+}
+
+// delayed: like Lua delayed(), the input shows up on the output after the
+// delay. A new input while a delay is pending restarts it with the new value.
+struct DelayedState {
+    double pending = 0.0;
+    Clock::time_point due{};
+    bool armed = false;
+};
+
+inline void delayed_arm(DelayedState& state, double x, Clock::time_point now,
+                        Clock::duration delay) {
+    state.pending = x;
+    state.due = now + delay;
+    state.armed = true;
+}
+
+inline bool delayed_fire(DelayedState& state, Clock::time_point now, double& out) {
+    if (!state.armed || now < state.due) {
+        return false;
+    }
+    state.armed = false;
+    out = state.pending;
+    return true;
+}
+
+// Sampling: filters with rate_hz > 0 also run on a fixed cadence that starts
+// with their first input; |next_sample_s| starts out as kNever. Returns
+// whether the filter takes a sample now.
+constexpr double kNever = std::numeric_limits<double>::infinity();
+
+inline bool sample_active(bool changed, double now_s, double period_s, double& next_sample_s) {
+    if (period_s > 0.0) {
+        if (now_s >= next_sample_s) {
+            next_sample_s += period_s;
+            if (next_sample_s <= now_s) {
+                next_sample_s = now_s + period_s;  // Fell behind; do not burst to catch up
+            }
+            return true;
+        }
+        if (changed && next_sample_s == kNever) {
+            next_sample_s = now_s + period_s;
+        }
+    }
+    return changed;
+}
+
+// lowpass: exponential moving average, the first sample primes the filter
+inline double lowpass_step(double y, double x, double alpha, bool primed) {
+    return primed ? y + alpha * (x - y) : x;
+}
+
+// derivative: rate of change per second since the previous sample
+inline double derivative_step(double x, double prev_x, double dt_s, bool primed) {
+    const bool valid = primed && dt_s > 0.0;
+    return (x - prev_x) / (valid ? dt_s : 1.0) * valid;
+}
+
+// moving_average: mean of the last |window| samples kept in |ring|. |sum| is
+// a running total, recomputed from the ring each time |head| wraps so that
+// rounding error never outlives one window: O(1) per sample, amortized.
+inline double moving_average_step(double* ring, uint32_t window, uint32_t& head, uint32_t& count, double& sum,
+                                  double x) {
+    const double evicted = count == window ? ring[head] : 0.0;
+    ring[head] = x;
+    head = head + 1 == window ? 0 : head + 1;
+    if (count < window) {
+        ++count;
+    }
+    if (head == 0) {
+        sum = 0.0;
+        for (uint32_t i = 0; i < count; ++i) {
+            sum += ring[i];
+        }
+    } else {
+        sum += x - evicted;
+    }
+    return sum / count;
+}
+
+// sustained_condition: 1 once the input has been non-zero for |duration_s|.
+// |since_s| is negative while the condition is false.
+inline double sustained_step(bool condition, double now_s, double duration_s, double& since_s) {
+    if (!condition) {
+        since_s = -1.0;
+        return 0.0;
+    }
+    if (since_s < 0.0) {
+        since_s = now_s;
+    }
+    return now_s - since_s >= duration_s ? 1.0 : 0.0;
+}
+
+// noise: x plus gaussian noise. Counter-based, so a lane's sequence depends
+// only on its key and sample count, never on evaluation order.
+inline uint64_t mix64(uint64_t z) {
+    z += 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+inline double unit_uniform(uint64_t bits) {
+    return (static_cast<double>(bits >> 11) + 0.5) * (1.0 / 9007199254740992.0);  // (0, 1)
+}
+
+inline double noise_step(double x, double stddev, uint64_t key, uint64_t counter) {
+    const double u1 = unit_uniform(mix64(key ^ (counter * 2)));
+    const double u2 = unit_uniform(mix64(key ^ (counter * 2 + 1)));
+    return x + stddev * std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+}
+
+// Bank kernels: the same steps over contiguous per-signal arrays. Lanes are
+// only updated where active[i] is set. The loops are branch-free and use a
+// bitwise blend so GCC and Clang vectorize them across signals (with
+// -fno-trapping-math, see CMakeLists.txt); blend() keeps results bit-identical
+// to the scalar steps used by generated code.
+
+inline double blend(bool take, double a, double b) {
+    uint64_t ua;
+    uint64_t ub;
+    std::memcpy(&ua, &a, sizeof(ua));
+    std::memcpy(&ub, &b, sizeof(ub));
+    const uint64_t mask = 0 - static_cast<uint64_t>(take);
+    const uint64_t bits = (ua & mask) | (ub & ~mask);
+    double out;
+    std::memcpy(&out, &bits, sizeof(out));
+    return out;
+}
+
+inline void lowpass_bank(size_t n, const double* __restrict x, const double* __restrict alpha,
+                         const uint8_t* __restrict active, uint8_t* __restrict primed, double* __restrict y) {
+    for (size_t i = 0; i < n; ++i) {
+        const double next = lowpass_step(y[i], x[i], alpha[i], primed[i] != 0);
+        y[i] = blend(active[i] != 0, next, y[i]);
+        primed[i] = primed[i] | active[i];
+    }
+}
+
+inline void derivative_bank(size_t n, const double* __restrict x, const uint8_t* __restrict active, double now_s,
+                            double* __restrict prev_x, double* __restrict prev_t, uint8_t* __restrict primed,
+                            double* __restrict y) {
+    for (size_t i = 0; i < n; ++i) {
+        const bool take = active[i] != 0;
+        const double next = derivative_step(x[i], prev_x[i], now_s - prev_t[i], primed[i] != 0);
+        y[i] = blend(take, next, y[i]);
+        prev_x[i] = blend(take, x[i], prev_x[i]);
+        prev_t[i] = blend(take, now_s, prev_t[i]);
+        primed[i] = primed[i] | active[i];
+    }
+}
+
+// The transcendental part of noise_step stays scalar unless vector math
+// routines are available; the state is still kept per bank.
+inline void noise_bank(size_t n, const double* __restrict x, const double* __restrict stddev,
+                       const uint64_t* __restrict key, const uint8_t* __restrict active,
+                       uint64_t* __restrict counter, double* __restrict y) {
+    for (size_t i = 0; i < n; ++i) {
+        if (active[i]) {
+            y[i] = noise_step(x[i], stddev[i], key[i], counter[i]++);
+        }
+    }
+}
+
+}  // namespace fixture_native
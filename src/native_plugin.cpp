@@ -0,0 +1,105 @@
+#include "native_plugin.hpp"
+
+#include <cmath>
+#include <dlfcn.h>
+
+using vss::types::ValueType;
+
+NativePlugin::~NativePlugin() {
+    if (handle_) {
+        dlclose(handle_);
+    }
+}
+
+std::shared_ptr<NativePlugin> NativePlugin::Load(const std::string& library, const std::string& fn,
+                                                 std::string& error) {
+    std::shared_ptr<NativePlugin> plugin(new NativePlugin());
+    plugin->library_ = library;
+    plugin->fn_ = fn;
+
+    plugin->handle_ = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!plugin->handle_) {
+        error = "cannot load plugin " + library + ": " + dlerror();
+        return nullptr;
+    }
+
+    auto abi_version = reinterpret_cast<fixture_abi_version_fn>(
+        dlsym(plugin->handle_, "fixture_plugin_abi_version"));
+    if (!abi_version) {
+        error = library + " does not export fixture_plugin_abi_version";
+        return nullptr;
+    }
+    if (abi_version() != FIXTURE_PLUGIN_ABI_VERSION) {
+        error = library + " was built for plugin ABI " + std::to_string(abi_version()) +
+                ", runner supports " + std::to_string(FIXTURE_PLUGIN_ABI_VERSION);
+        return nullptr;
+    }
+
+    plugin->transform_ = reinterpret_cast<fixture_transform_fn>(dlsym(plugin->handle_, fn.c_str()));
+    if (!plugin->transform_) {
+        error = library + " does not export " + fn;
+        return nullptr;
+    }
+    plugin->create_ = reinterpret_cast<fixture_create_fn>(dlsym(plugin->handle_, (fn + "_create").c_str()));
+    plugin->destroy_ = reinterpret_cast<fixture_destroy_fn>(dlsym(plugin->handle_, (fn + "_destroy").c_str()));
+    return plugin;
+}
+
+void* NativePlugin::CreateState(const std::vector<fixture_param>& params) const {
+    return create_ ? create_(params.data(), params.size()) : nullptr;
+}
+
+void NativePlugin::DestroyState(void* state) const {
+    if (destroy_ && state) {
+        destroy_(state);
+    }
+}
+
+fixture_type PluginTypeFor(ValueType type) {
+    switch (type) {
+        case ValueType::BOOL:
+            return FIXTURE_TYPE_BOOL;
+        case ValueType::INT8:
+        case ValueType::INT16:
+        case ValueType::INT32:
+        case ValueType::INT64:
+            return FIXTURE_TYPE_INT64;
+        case ValueType::UINT8:
+        case ValueType::UINT16:
+        case ValueType::UINT32:
+        case ValueType::UINT64:
+            return FIXTURE_TYPE_UINT64;
+        default:
+            return FIXTURE_TYPE_DOUBLE;
+    }
+}
+
+fixture_value PluginValueFromNative(double value, fixture_type type) {
+    fixture_value out;
+    out.type = type;
+    switch (type) {
+        case FIXTURE_TYPE_BOOL:
+            out.as.b = value != 0.0;
+            break;
+        case FIXTURE_TYPE_INT64:
+            out.as.i64 = std::llround(value);
+            break;
+        case FIXTURE_TYPE_UINT64:
+            out.as.u64 = value <= 0.0 ? 0 : static_cast<uint64_t>(std::llround(value));
+            break;
+        default:
+            out.type = FIXTURE_TYPE_DOUBLE;
+            out.as.f64 = value;
+            break;
+    }
+    return out;
+}
+
+double NativeValueFromPlugin(const fixture_value& value) {
+    switch (value.type) {
+        case FIXTURE_TYPE_BOOL: return value.as.b ? 1.0 : 0.0;
+        case FIXTURE_TYPE_INT64: return static_cast<double>(value.as.i64);
+        case FIXTURE_TYPE_UINT64: return static_cast<double>(value.as.u64);
+        default: return value.as.f64;
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <vss/types/value.hpp>
+#include "fixture_plugin.h"
+
+/**
+ * @brief A transform function resolved from a plugin library
+ *
+ * Keeps the library loaded for as long as any mapping references it.
+ */
+class NativePlugin {
+public:
+    ~NativePlugin();
+
+    NativePlugin(const NativePlugin&) = delete;
+    NativePlugin& operator=(const NativePlugin&) = delete;
+
+    /**
+     * @brief dlopen |library| and resolve transform |fn|
+     * @return nullptr with |error| set on failure
+     */
+    static std::shared_ptr<NativePlugin> Load(const std::string& library, const std::string& fn,
+                                              std::string& error);
+
+    const std::string& library() const { return library_; }
+    const std::string& fn() const { return fn_; }
+
+    void* CreateState(const std::vector<fixture_param>& params) const;
+    void DestroyState(void* state) const;
+    int Call(fixture_call& call) const { return transform_(&call); }
+
+private:
+    NativePlugin() = default;
+
+    std::string library_;
+    std::string fn_;
+    void* handle_ = nullptr;
+    fixture_transform_fn transform_ = nullptr;
+    fixture_create_fn create_ = nullptr;
+    fixture_destroy_fn destroy_ = nullptr;
+};
+
+// Conversions between native doubles and plugin values
+fixture_type PluginTypeFor(vss::types::ValueType type);
+fixture_value PluginValueFromNative(double value, fixture_type type);
+double NativeValueFromPlugin(const fixture_value& value);
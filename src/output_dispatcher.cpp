@@ -0,0 +1,173 @@
+#include "output_dispatcher.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <glog/logging.h>
+#include "native_graph.hpp"
+
+OutputDispatcher::Sink::Sink(const std::string& name, std::unique_ptr<OutputSink> output, SinkOptions options,
+                             MetricsRegistry& metrics)
+    : name(name),
+      output(std::move(output)),
+      options(options),
+      ring(options.inline_write ? 1 : options.capacity),
+      dropped_total(metrics.counter("dispatch." + name + ".dropped_total")),
+      full_waits_total(metrics.counter("dispatch." + name + ".full_waits_total")) {}
+
+OutputDispatcher::OutputDispatcher(MetricsRegistry& metrics, std::function<void(uint64_t)> acknowledged)
+    : metrics_(metrics), acknowledged_(std::move(acknowledged)) {}
+
+OutputDispatcher::~OutputDispatcher() {
+    stop();
+}
+
+void OutputDispatcher::add_sink(const std::string& name, std::unique_ptr<OutputSink> sink, SinkOptions options) {
+    sinks_.push_back(std::make_unique<Sink>(name, std::move(sink), options, metrics_));
+    Sink& added = *sinks_.back();
+    added.on_sealed = [this, &added](uint64_t tag) {
+        // A sink sealing later may report from another thread; never step back
+        uint64_t sealed = added.sealed.load(std::memory_order_relaxed);
+        while (sealed < tag && !added.sealed.compare_exchange_weak(sealed, tag, std::memory_order_release)) {
+        }
+        Acknowledge();
+    };
+}
+
+void OutputDispatcher::start() {
+    running_ = true;
+    for (auto& sink : sinks_) {
+        if (sink->options.inline_write) {
+            continue;
+        }
+        sink->thread = std::thread([this, &sink = *sink] { Drain(sink); });
+    }
+}
+
+void OutputDispatcher::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    for (auto& sink : sinks_) {
+        if (sink->options.inline_write) {
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(sink->mutex);
+        }
+        sink->cv.notify_one();
+        sink->thread.join();
+    }
+}
+
+void OutputDispatcher::dispatch(const OutputTarget& target, vss::types::DynamicQualifiedValue value) {
+    Sink* last = nullptr;
+    for (auto& sink : sinks_) {
+        if (sink->options.channel && *sink->options.channel != target.channel) {
+            continue;
+        }
+        if (sink->options.inline_write) {
+            sink->output->write(target, value);
+            continue;
+        }
+        if (last) {
+            Push(*last, Item{&target, value, 0});
+        }
+        last = sink.get();
+    }
+    if (last) {
+        Push(*last, Item{&target, std::move(value), 0});
+    }
+}
+
+void OutputDispatcher::seal(uint64_t tag) {
+    bool any = false;
+    for (auto& sink : sinks_) {
+        if (!sink->options.acknowledges) {
+            continue;
+        }
+        if (sink->options.inline_write) {
+            sink->output->seal(tag, sink->on_sealed);
+        } else {
+            Push(*sink, Item{nullptr, {}, tag});
+        }
+        any = true;
+    }
+    if (!any) {
+        acknowledged_(tag);
+    }
+}
+
+void OutputDispatcher::Push(Sink& sink, Item&& item) {
+    if (!sink.ring.try_push(std::move(item))) {
+        if (sink.options.drop_when_full && item.target) {
+            sink.dropped_total.inc();
+            return;
+        }
+        sink.full_waits_total.inc();
+        while (!sink.ring.try_push(std::move(item))) {
+            if (!running_) {
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    // Pairs with the consumer setting |sleeping| before its last look at the ring
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sink.sleeping.load(std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lock(sink.mutex);
+        sink.cv.notify_one();
+    }
+}
+
+void OutputDispatcher::Drain(Sink& sink) {
+    Item item;
+    while (true) {
+        while (sink.ring.try_pop(item)) {
+            if (item.target) {
+                sink.output->write(*item.target, item.value);
+            } else {
+                sink.output->seal(item.tag, sink.on_sealed);
+            }
+        }
+        if (!running_ && sink.ring.size() == 0) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(sink.mutex);
+        sink.sleeping.store(true, std::memory_order_seq_cst);
+        if (sink.ring.size() == 0 && running_) {
+            sink.cv.wait(lock);
+        }
+        sink.sleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+void OutputDispatcher::Acknowledge() {
+    std::lock_guard<std::mutex> lock(ack_mutex_);
+    uint64_t tag = std::numeric_limits<uint64_t>::max();
+    for (const auto& sink : sinks_) {
+        if (sink->options.acknowledges) {
+            tag = std::min(tag, sink->sealed.load(std::memory_order_acquire));
+        }
+    }
+    if (tag > acknowledged_tag_) {
+        acknowledged_tag_ = tag;
+        acknowledged_(tag);
+    }
+}
+
+void BrokerSink::write(const OutputTarget& target, const vss::types::DynamicQualifiedValue& value) {
+    auto status = client_.publish(*target.handle, value);
+    if (!status.ok()) {
+        LOG_EVERY_N(ERROR, 100) << "Failed to publish " << target.signal << ": " << status;
+    }
+}
+
+void CaptureSink::write(const OutputTarget& target, const vss::types::DynamicQualifiedValue& value) {
+    // Only numeric and boolean values are captured
+    if (auto number = NativeValueFromVss(value.value)) {
+        capture_.record(target.signal, std::chrono::duration_cast<std::chrono::microseconds>(
+            value.timestamp.time_since_epoch()).count(), *number);
+    }
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <kuksa_cpp/kuksa.hpp>
+#include <vss/types/quality.hpp>
+#include "capture.hpp"
+#include "metrics.hpp"
+#include "spsc_ring.hpp"
+
+// Where an output signal goes: its resolved handle and publish channel
+struct OutputTarget {
+    std::string signal;
+    std::shared_ptr<kuksa::DynamicSignalHandle> handle;
+    size_t channel = 0;  // Index into BrokerPool::Connection::publishers
+    vss::types::SignalQuality quality = vss::types::SignalQuality::UNKNOWN;  // Last published; producer only
+};
+
+/**
+ * @brief Destination of published outputs, written from its own thread
+ */
+class OutputSink {
+public:
+    using Sealed = std::function<void(uint64_t tag)>;
+
+    virtual ~OutputSink() = default;
+
+    virtual void write(const OutputTarget& target, const vss::types::DynamicQualifiedValue& value) = 0;
+
+    // End of generation |tag|: call |sealed| with it once the outputs written
+    // before are out. A sink that publishes later keeps |sealed|, which
+    // outlives it, and calls it then, from any thread.
+    virtual void seal(uint64_t tag, const Sealed& sealed) { sealed(tag); }
+};
+
+/**
+ * @brief Hands each output of a DAG pass to every destination
+ *
+ * Each sink has a lock-free single-producer ring drained by its own thread,
+ * so a slow sink (a disk) never holds up another (the broker). The producer
+ * is the runner's DAG owner thread. When a ring is full the output is either
+ * dropped and counted, or the producer waits for room, per sink.
+ *
+ * seal(tag) closes a generation of outputs. Once every acknowledging sink
+ * has put out all outputs before it (OutputSink::seal), the acknowledged
+ * callback receives the tag; the runner tags with ingress sequence numbers to
+ * release commands waiting for their outputs to be published. Tags must
+ * increase.
+ *
+ * An inline sink has no ring or thread: dispatch() writes to it directly,
+ * for runners sharing a few pool threads where a thread per sink would
+ * outnumber them.
+ */
+class OutputDispatcher {
+public:
+    struct SinkOptions {
+        size_t capacity = 4096;               // Ring slots
+        bool drop_when_full = false;          // Otherwise dispatch() waits for room
+        bool acknowledges = false;            // Takes part in seal() generations
+        std::optional<size_t> channel;        // Only targets on this channel; all if unset
+        bool inline_write = false;            // Written by the producer thread, no ring
+    };
+
+    OutputDispatcher(MetricsRegistry& metrics, std::function<void(uint64_t)> acknowledged);
+    ~OutputDispatcher();  // Stops after the sinks have drained
+
+    OutputDispatcher(const OutputDispatcher&) = delete;
+    OutputDispatcher& operator=(const OutputDispatcher&) = delete;
+
+    // Before start() only
+    void add_sink(const std::string& name, std::unique_ptr<OutputSink> sink, SinkOptions options);
+
+    void start();
+    void stop();
+
+    // Producer thread only; |target| must outlive the dispatcher. |value| is
+    // copied for all but the last sink taking it, which gets it moved.
+    void dispatch(const OutputTarget& target, vss::types::DynamicQualifiedValue value);
+    void seal(uint64_t tag);
+
+private:
+    struct Item {
+        const OutputTarget* target = nullptr;  // nullptr: end of a generation
+        vss::types::DynamicQualifiedValue value;
+        uint64_t tag = 0;
+    };
+
+    struct Sink {
+        std::string name;
+        std::unique_ptr<OutputSink> output;
+        SinkOptions options;
+        SpscRing<Item> ring;
+        Counter& dropped_total;
+        Counter& full_waits_total;
+
+        // Consumer wakeup; the producer only takes the mutex when the consumer sleeps
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::atomic<bool> sleeping{false};
+        std::atomic<uint64_t> sealed{0};  // Tag of the last generation fully put out
+        OutputSink::Sealed on_sealed;     // Advances |sealed|
+        std::thread thread;
+
+        Sink(const std::string& name, std::unique_ptr<OutputSink> output, SinkOptions options,
+             MetricsRegistry& metrics);
+    };
+
+    void Push(Sink& sink, Item&& item);
+    void Drain(Sink& sink);
+    void Acknowledge();
+
+    MetricsRegistry& metrics_;
+    std::function<void(uint64_t)> acknowledged_;
+    std::vector<std::unique_ptr<Sink>> sinks_;
+    std::atomic<bool> running_{false};
+
+    std::mutex ack_mutex_;
+    uint64_t acknowledged_tag_ = 0;
+};
+
+/**
+ * @brief Publishes outputs on one broker channel
+ */
+class BrokerSink : public OutputSink {
+public:
+    explicit BrokerSink(kuksa::Client& client) : client_(client) {}
+
+    void write(const OutputTarget& target, const vss::types::DynamicQualifiedValue& value) override;
+
+private:
+    kuksa::Client& client_;
+};
+
+/**
+ * @brief Records numeric and boolean outputs into a capture file
+ */
+class CaptureSink : public OutputSink {
+public:
+    explicit CaptureSink(CaptureWriter& capture) : capture_(capture) {}
+
+    void write(const OutputTarget& target, const vss::types::DynamicQualifiedValue& value) override;
+
+private:
+    CaptureWriter& capture_;
+};
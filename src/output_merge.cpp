@@ -0,0 +1,134 @@
+#include "output_merge.hpp"
+
+#include <algorithm>
+#include <glog/logging.h>
+
+OutputMerge::OutputMerge(BrokerPool::Connection& connection, std::chrono::milliseconds quantum,
+                         std::chrono::milliseconds hold, MetricsRegistry& metrics)
+    : connection_(connection),
+      quantum_(std::max(quantum, std::chrono::milliseconds(1))),
+      hold_(std::max(hold, quantum_)),
+      published_total_(metrics.counter("merge.published_total")),
+      superseded_total_(metrics.counter("merge.superseded_total")) {}
+
+OutputMerge::~OutputMerge() {
+    stop();
+}
+
+void OutputMerge::add_path(const std::string& path) {
+    if (index_.emplace(path, slots_.size()).second) {
+        Slot slot;
+        slot.path = path;
+        slot.channel = connection_.channel_for(path);
+        slots_.push_back(std::move(slot));
+    }
+}
+
+void OutputMerge::start() {
+    running_ = true;
+    thread_ = std::thread([this] { Run(); });
+}
+
+void OutputMerge::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    cv_.notify_one();
+    thread_.join();
+}
+
+uint64_t OutputMerge::write(const OutputTarget& target, const vss::types::DynamicQualifiedValue& value,
+                            int precedence) {
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t index = index_.at(target.signal);
+    Slot& slot = slots_[index];
+    if (precedence < slot.precedence && now < slot.held_until) {
+        superseded_total_.inc();
+        return 0;
+    }
+    if (slot.pending) {
+        superseded_total_.inc();
+    } else {
+        slot.pending = true;
+        dirty_.push_back(index);
+    }
+    slot.handle = target.handle;
+    slot.value = value;
+    slot.precedence = precedence;
+    slot.held_until = now + hold_;
+    return next_flush_;
+}
+
+void OutputMerge::when_flushed(uint64_t flush, std::function<void()> done) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (flush > flushed_) {
+            waiting_.emplace_back(flush, std::move(done));
+            return;
+        }
+    }
+    done();
+}
+
+void OutputMerge::Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto next = std::chrono::steady_clock::now() + quantum_;
+    while (running_) {
+        cv_.wait_until(lock, next, [this] { return !running_; });
+        next = std::max(next + quantum_, std::chrono::steady_clock::now());
+        lock.unlock();
+        Flush();
+        lock.lock();
+    }
+    lock.unlock();
+    Flush();
+}
+
+void OutputMerge::Flush() {
+    struct Write {
+        size_t channel;
+        std::shared_ptr<kuksa::DynamicSignalHandle> handle;
+        vss::types::DynamicQualifiedValue value;
+        const std::string* path;
+    };
+    std::vector<Write> writes;
+    uint64_t flush;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flush = next_flush_++;
+        writes.reserve(dirty_.size());
+        for (size_t index : dirty_) {
+            Slot& slot = slots_[index];
+            writes.push_back(Write{slot.channel, slot.handle, slot.value, &slot.path});
+            slot.pending = false;
+        }
+        dirty_.clear();
+    }
+
+    for (const auto& write : writes) {
+        auto status = connection_.publishers[write.channel]->publish(*write.handle, write.value);
+        if (!status.ok()) {
+            LOG_EVERY_N(ERROR, 100) << "Failed to publish " << *write.path << ": " << status;
+        }
+    }
+    published_total_.inc(writes.size());
+
+    // Callbacks waiting for this flush, in the order they were added
+    std::vector<std::pair<uint64_t, std::function<void()>>> due;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flushed_ = flush;
+        auto first_waiting = std::stable_partition(waiting_.begin(), waiting_.end(),
+                                                   [flush](const auto& entry) { return entry.first <= flush; });
+        due.assign(std::make_move_iterator(waiting_.begin()), std::make_move_iterator(first_waiting));
+        waiting_.erase(waiting_.begin(), first_waiting);
+    }
+    for (auto& entry : due) {
+        entry.second();
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "broker_pool.hpp"
+#include "metrics.hpp"
+#include "output_dispatcher.hpp"
+
+/**
+ * @brief Publishes paths written by several fixtures once per quantum
+ *
+ * Outputs of covered paths are held rather than published. Every quantum the
+ * latest held value of each path is published on the path's broker channel,
+ * so fixtures computing the same output cost one broker write, not one each.
+ *
+ * A write from a fixture with lower precedence than the path's current writer
+ * is dropped until that writer has been silent for the hold time; equal
+ * precedence is last writer wins. This keeps conflicting fixtures from
+ * taking turns on a path.
+ *
+ * Flushes are numbered from 1. write() returns the flush that publishes the
+ * value, and when_flushed() runs a callback once that flush is done, which
+ * is when a MergeSink acknowledges.
+ */
+class OutputMerge {
+public:
+    OutputMerge(BrokerPool::Connection& connection, std::chrono::milliseconds quantum,
+                std::chrono::milliseconds hold, MetricsRegistry& metrics);
+    ~OutputMerge();  // Publishes what is still held
+
+    OutputMerge(const OutputMerge&) = delete;
+    OutputMerge& operator=(const OutputMerge&) = delete;
+
+    // Before start() only
+    void add_path(const std::string& path);
+    bool covers(const std::string& path) const { return index_.count(path) != 0; }
+
+    void start();
+    void stop();
+
+    // Any thread; |target| must be a covered path. Returns the flush that
+    // publishes |value|, 0 if it is dropped.
+    uint64_t write(const OutputTarget& target, const vss::types::DynamicQualifiedValue& value, int precedence);
+
+    // Any thread; runs |done| once flush |flush| has published, right away
+    // if it already has, otherwise on the merge thread
+    void when_flushed(uint64_t flush, std::function<void()> done);
+
+private:
+    struct Slot {
+        std::string path;
+        size_t channel = 0;
+        std::shared_ptr<kuksa::DynamicSignalHandle> handle;
+        vss::types::DynamicQualifiedValue value;
+        int precedence = 0;
+        std::chrono::steady_clock::time_point held_until;
+        bool pending = false;
+    };
+
+    void Run();
+    void Flush();
+
+    BrokerPool::Connection& connection_;
+    const std::chrono::milliseconds quantum_;
+    const std::chrono::milliseconds hold_;
+
+    std::unordered_map<std::string, size_t> index_;  // Path -> slot
+    std::vector<Slot> slots_;
+    std::vector<size_t> dirty_;  // Slots with a pending value
+    uint64_t next_flush_ = 1;    // Publishes the pending values
+    uint64_t flushed_ = 0;       // Last flush done
+    std::vector<std::pair<uint64_t, std::function<void()>>> waiting_;  // when_flushed() callbacks
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool running_ = false;
+    std::thread thread_;
+
+    Counter& published_total_;
+    Counter& superseded_total_;
+};
+
+/**
+ * @brief Hands one fixture's outputs of merged paths to an OutputMerge
+ *
+ * A generation is sealed once the merge has published what was written
+ * before it, not when it was handed over.
+ */
+class MergeSink : public OutputSink {
+public:
+    MergeSink(OutputMerge& merge, int precedence) : merge_(merge), precedence_(precedence) {}
+
+    void write(const OutputTarget& target, const vss::types::DynamicQualifiedValue& value) override {
+        last_flush_ = std::max(last_flush_, merge_.write(target, value, precedence_));
+    }
+
+    void seal(uint64_t tag, const Sealed& sealed) override {
+        merge_.when_flushed(last_flush_, [&sealed, tag] { sealed(tag); });
+    }
+
+private:
+    OutputMerge& merge_;
+    int precedence_;
+    uint64_t last_flush_ = 0;  // Flush publishing the latest write
+};
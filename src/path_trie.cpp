@@ -0,0 +1,185 @@
+#include "path_trie.hpp"
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+
+namespace {
+
+// Segments of a dotted path; views into |path|
+std::vector<std::string_view> SplitPath(std::string_view path) {
+    std::vector<std::string_view> segments;
+    if (path.empty()) {
+        return segments;
+    }
+    size_t start = 0;
+    while (true) {
+        const size_t dot = path.find('.', start);
+        segments.push_back(path.substr(start, dot == std::string_view::npos ? std::string_view::npos : dot - start));
+        if (dot == std::string_view::npos) {
+            return segments;
+        }
+        start = dot + 1;
+    }
+}
+
+}  // namespace
+
+PathTrie::PathTrie(const std::vector<std::string>& paths) {
+    // Pointer-linked build tree first, then laid out breadth-first
+    struct BuildNode {
+        std::map<std::string_view, uint32_t> children;
+        uint32_t value = kNoValue;
+    };
+    std::vector<BuildNode> build(1);
+    for (size_t i = 0; i < paths.size(); ++i) {
+        uint32_t node = 0;
+        for (std::string_view segment : SplitPath(paths[i])) {
+            auto [it, inserted] = build[node].children.emplace(segment, static_cast<uint32_t>(build.size()));
+            if (inserted) {
+                build.emplace_back();
+            }
+            node = it->second;
+        }
+        if (build[node].value == kNoValue) {
+            build[node].value = static_cast<uint32_t>(i);
+            ++size_;
+        }
+    }
+
+    std::unordered_map<std::string_view, uint32_t> interned;
+    auto intern = [&](std::string_view segment) {
+        auto [it, inserted] = interned.emplace(segment, static_cast<uint32_t>(arena_.size()));
+        if (inserted) {
+            arena_.append(segment);
+        }
+        return it->second;
+    };
+
+    // order[k] is the build node laid out at nodes_[k]
+    std::vector<uint32_t> order{0};
+    order.reserve(build.size());
+    nodes_.reserve(build.size());
+    nodes_.emplace_back();
+    for (size_t k = 0; k < order.size(); ++k) {
+        const BuildNode& node = build[order[k]];
+        nodes_[k].value = node.value;
+        nodes_[k].first_child = static_cast<uint32_t>(nodes_.size());
+        nodes_[k].child_count = static_cast<uint32_t>(node.children.size());
+        for (const auto& [segment, child] : node.children) {
+            Node laid_out;
+            laid_out.segment = intern(segment);
+            laid_out.segment_size = static_cast<uint32_t>(segment.size());
+            nodes_.push_back(laid_out);
+            order.push_back(child);
+        }
+    }
+    arena_.shrink_to_fit();
+}
+
+const PathTrie::Node* PathTrie::Child(const Node& node, std::string_view segment) const {
+    const Node* first = nodes_.data() + node.first_child;
+    const Node* last = first + node.child_count;
+    const Node* it = std::lower_bound(first, last, segment,
+                                      [this](const Node& child, std::string_view key) { return Segment(child) < key; });
+    return it != last && Segment(*it) == segment ? it : nullptr;
+}
+
+const PathTrie::Node* PathTrie::Walk(std::string_view path) const {
+    if (nodes_.empty()) {
+        return nullptr;
+    }
+    const Node* node = &nodes_[0];
+    if (path.empty()) {
+        return node;
+    }
+    size_t start = 0;
+    while (node) {
+        const size_t dot = path.find('.', start);
+        if (dot == std::string_view::npos) {
+            return Child(*node, path.substr(start));
+        }
+        node = Child(*node, path.substr(start, dot - start));
+        start = dot + 1;
+    }
+    return nullptr;
+}
+
+std::optional<uint32_t> PathTrie::find(std::string_view path) const {
+    const Node* node = path.empty() ? nullptr : Walk(path);
+    if (!node || node->value == kNoValue) {
+        return std::nullopt;
+    }
+    return node->value;
+}
+
+void PathTrie::subtree(std::string_view prefix, std::vector<uint32_t>& values) const {
+    if (const Node* node = Walk(prefix)) {
+        Collect(*node, values);
+    }
+}
+
+void PathTrie::Collect(const Node& node, std::vector<uint32_t>& values) const {
+    if (node.value != kNoValue) {
+        values.push_back(node.value);
+    }
+    for (uint32_t i = 0; i < node.child_count; ++i) {
+        Collect(nodes_[node.first_child + i], values);
+    }
+}
+
+void PathTrie::match(std::string_view pattern, std::vector<uint32_t>& values) const {
+    if (nodes_.empty()) {
+        return;
+    }
+    // Consecutive '**' match the same paths as one
+    std::vector<std::string_view> segments = SplitPath(pattern);
+    segments.erase(std::unique(segments.begin(), segments.end(),
+                               [](std::string_view a, std::string_view b) { return a == "**" && b == "**"; }),
+                   segments.end());
+
+    // A path can match through more than one '**' split ("**.B.**" and
+    // A.B.B), and reach the same (node, pattern segment) state each time.
+    // Visiting every state once bounds the work to nodes x segments and
+    // reports every match once.
+    MatchState state;
+    state.stride = segments.size() + 1;
+    state.visited.assign(nodes_.size() * state.stride, 0);
+    state.matched.assign(nodes_.size(), 0);
+    Match(0, segments, 0, state);
+    for (size_t index = 0; index < nodes_.size(); ++index) {
+        if (state.matched[index]) {
+            values.push_back(nodes_[index].value);
+        }
+    }
+}
+
+void PathTrie::Match(uint32_t index, const std::vector<std::string_view>& pattern, size_t next,
+                     MatchState& state) const {
+    uint8_t& visited = state.visited[index * state.stride + next];
+    if (visited) {
+        return;
+    }
+    visited = 1;
+
+    const Node& node = nodes_[index];
+    if (next == pattern.size()) {
+        if (node.value != kNoValue) {
+            state.matched[index] = 1;
+        }
+        return;
+    }
+    const std::string_view segment = pattern[next];
+    if (segment == "**") {
+        Match(index, pattern, next + 1, state);
+        for (uint32_t i = 0; i < node.child_count; ++i) {
+            Match(node.first_child + i, pattern, next, state);
+        }
+    } else if (segment == "*") {
+        for (uint32_t i = 0; i < node.child_count; ++i) {
+            Match(node.first_child + i, pattern, next + 1, state);
+        }
+    } else if (const Node* child = Child(node, segment)) {
+        Match(static_cast<uint32_t>(child - nodes_.data()), pattern, next + 1, state);
+    }
+}
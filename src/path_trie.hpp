@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Read-only trie of dotted VSS paths, built once
+ *
+ * Path i of the list it is built from gets value i. Nodes are laid out
+ * breadth-first in one array with the children of a node contiguous and
+ * sorted, and each distinct segment ("Row1", "IsLocked") is stored once in a
+ * shared character arena, so large catalogues cost a few words per node.
+ * Lookups walk one node per segment.
+ *
+ * Patterns for match() use '*' for exactly one segment and '**' for any
+ * number of segments, including none.
+ */
+class PathTrie {
+public:
+    static constexpr uint32_t kNoValue = UINT32_MAX;
+
+    PathTrie() = default;
+    explicit PathTrie(const std::vector<std::string>& paths);  // A repeated path keeps its first value
+
+    std::optional<uint32_t> find(std::string_view path) const;
+    bool contains(std::string_view path) const { return find(path).has_value(); }
+
+    // Values of |prefix| and every path below it, depth-first with the
+    // segments below a node sorted; all if |prefix| is empty
+    void subtree(std::string_view prefix, std::vector<uint32_t>& values) const;
+
+    // Values of the paths matching |pattern|, each once, in breadth-first
+    // trie order: shorter paths first, then by segment
+    void match(std::string_view pattern, std::vector<uint32_t>& values) const;
+
+    size_t size() const { return size_; }
+    size_t node_count() const { return nodes_.size(); }
+
+private:
+    struct Node {
+        uint32_t segment = 0;      // Offset into arena_
+        uint32_t segment_size = 0;
+        uint32_t first_child = 0;  // Index of the first child in nodes_
+        uint32_t child_count = 0;
+        uint32_t value = kNoValue;
+    };
+
+    std::string_view Segment(const Node& node) const {
+        return std::string_view(arena_).substr(node.segment, node.segment_size);
+    }
+    const Node* Child(const Node& node, std::string_view segment) const;
+    const Node* Walk(std::string_view path) const;
+    void Collect(const Node& node, std::vector<uint32_t>& values) const;
+    struct MatchState {
+        size_t stride = 0;             // Pattern segments + 1
+        std::vector<uint8_t> visited;  // (node, next segment) states already tried
+        std::vector<uint8_t> matched;  // Nodes whose path matches
+    };
+    void Match(uint32_t index, const std::vector<std::string_view>& pattern, size_t next,
+               MatchState& state) const;
+
+    std::vector<Node> nodes_;  // nodes_[0] is the root, with an empty segment
+    std::string arena_;
+    size_t size_ = 0;
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief Bounded lock-free queue for one producer thread and one consumer thread
+ *
+ * Capacity is rounded up to a power of two. Slots are reused, so T must be
+ * default-constructible and move-assignable; a popped slot keeps its moved-from
+ * value until it is overwritten.
+ */
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        slots_ = std::make_unique<T[]>(size);
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // Producer only; false if the ring is full (|value| is left untouched)
+    bool try_push(T&& value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ > mask_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ > mask_) {
+                return false;
+            }
+        }
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_seq_cst);
+        return true;
+    }
+
+    // Consumer only; false if the ring is empty
+    bool try_pop(T& value) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_seq_cst);
+            if (head == tail_cache_) {
+                return false;
+            }
+        }
+        value = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Any thread; exact only when neither end is moving. Sequentially
+    // consistent, so a consumer can publish "about to sleep" and then check.
+    size_t size() const {
+        return tail_.load(std::memory_order_seq_cst) - head_.load(std::memory_order_seq_cst);
+    }
+
+private:
+    static constexpr size_t kLine = 64;
+
+    std::unique_ptr<T[]> slots_;
+    size_t mask_ = 0;
+
+    // Each end on its own cache line, with a cached copy of the other end
+    alignas(kLine) std::atomic<size_t> head_{0};
+    size_t tail_cache_ = 0;  // Consumer's view of tail_
+    alignas(kLine) std::atomic<size_t> tail_{0};
+    size_t head_cache_ = 0;  // Producer's view of head_
+};
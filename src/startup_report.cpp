@@ -0,0 +1,94 @@
+#include "startup_report.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sysexits.h>
+#include <glog/logging.h>
+#include <nlohmann/json.hpp>
+
+const char* StartupErrorName(StartupError error) {
+    switch (error) {
+        case StartupError::CONFIG:
+            return "config";
+        case StartupError::RESOLUTION:
+            return "resolution";
+        case StartupError::REGISTRATION:
+            return "registration";
+        case StartupError::DAG_INIT:
+            return "dag_init";
+        case StartupError::BROKER_UNREACHABLE:
+            return "broker_unreachable";
+        case StartupError::CAPTURE:
+            return "capture";
+    }
+    return "unknown";
+}
+
+int StartupExitCode(StartupError error) {
+    switch (error) {
+        case StartupError::CONFIG:
+            return EX_CONFIG;
+        case StartupError::RESOLUTION:
+            return EX_DATAERR;
+        case StartupError::REGISTRATION:
+            return EX_PROTOCOL;
+        case StartupError::DAG_INIT:
+            return EX_SOFTWARE;
+        case StartupError::BROKER_UNREACHABLE:
+            return EX_UNAVAILABLE;
+        case StartupError::CAPTURE:
+            return EX_CANTCREAT;
+    }
+    return 1;
+}
+
+void StartupReport::add_fixture(const std::string& name, const std::string& config_file, const std::string& broker,
+                                size_t actuators) {
+    fixtures_.push_back(Fixture{name, config_file, broker, actuators});
+}
+
+void StartupReport::write(const std::string& path, const std::optional<StartupFailure>& failure) const {
+    if (failure) {
+        LOG(ERROR) << "Startup failed (" << StartupErrorName(failure->error) << ", exit code "
+                   << StartupExitCode(failure->error) << ")"
+                   << (failure->fixture.empty() ? "" : " in fixture '" + failure->fixture + "'") << ": "
+                   << failure->detail;
+    }
+    if (path.empty()) {
+        return;
+    }
+
+    nlohmann::json j;
+    j["ok"] = !failure;
+    j["exit_code"] = failure ? StartupExitCode(failure->error) : 0;
+    if (failure) {
+        j["error"] = {
+            {"type", StartupErrorName(failure->error)},
+            {"transient", failure->error == StartupError::BROKER_UNREACHABLE},
+            {"fixture", failure->fixture},
+            {"detail", failure->detail},
+        };
+    }
+    j["fixtures"] = nlohmann::json::array();
+    for (const auto& fixture : fixtures_) {
+        j["fixtures"].push_back({
+            {"name", fixture.name},
+            {"config", fixture.config_file},
+            {"broker", fixture.broker},
+            {"actuators", fixture.actuators},
+        });
+    }
+
+    const std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream out(tmp_path, std::ios::trunc);
+        if (!out) {
+            LOG(WARNING) << "Cannot write startup report to " << tmp_path;
+            return;
+        }
+        out << j.dump(2) << "\n";
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        LOG(WARNING) << "Cannot replace startup report " << path;
+    }
+}
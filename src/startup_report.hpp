@@ -0,0 +1,54 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+// Why the runner could not start serving; each has its own exit code
+enum class StartupError {
+    CONFIG,              // A fixture file is missing or invalid
+    RESOLUTION,          // A signal path is not known to the broker
+    REGISTRATION,        // An actuator cannot be served (claimed twice)
+    DAG_INIT,            // The mappings do not form a valid graph
+    BROKER_UNREACHABLE,  // No connection to a broker; the only transient one
+    CAPTURE,             // The capture file cannot be created
+};
+
+struct StartupFailure {
+    StartupError error;
+    std::string detail;
+    std::string fixture;  // Empty if not tied to one
+};
+
+// Name of |error| in the startup report, e.g. "broker_unreachable"
+const char* StartupErrorName(StartupError error);
+
+// sysexits.h code main() returns for |error|
+int StartupExitCode(StartupError error);
+
+/**
+ * @brief Machine-readable summary of a runner's startup
+ *
+ * Lists the fixture parts that started and, on failure, the error that
+ * stopped the rest, so an orchestrator can tell a broker it should retry
+ * soon from a configuration that will never start. Written once, replacing
+ * the file atomically.
+ */
+class StartupReport {
+public:
+    void add_fixture(const std::string& name, const std::string& config_file, const std::string& broker,
+                     size_t actuators);
+
+    // Logs a failure; |path| empty writes nothing
+    void write(const std::string& path, const std::optional<StartupFailure>& failure) const;
+
+private:
+    struct Fixture {
+        std::string name;
+        std::string config_file;
+        std::string broker;
+        size_t actuators;
+    };
+
+    std::vector<Fixture> fixtures_;
+};
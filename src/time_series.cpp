@@ -0,0 +1,322 @@
+#include "time_series.hpp"
+
+#include <charconv>
+#include <iterator>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char kBinaryMagic[4] = {'F', 'X', 'T', 'S'};
+constexpr uint32_t kBinaryVersion = 1;
+constexpr size_t kBinaryHeaderSize = 24;
+
+bool IsBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Parse one CSV field starting at |p|; leaves |p| after the field's comma
+bool ParseField(const char*& p, const char* end, double& value) {
+    while (p < end && IsBlank(*p)) {
+        ++p;
+    }
+    auto [next, ec] = std::from_chars(p, end, value);
+    if (ec != std::errc()) {
+        return false;
+    }
+    p = next;
+    while (p < end && IsBlank(*p)) {
+        ++p;
+    }
+    if (p < end && *p == ',') {
+        ++p;
+    }
+    return true;
+}
+
+void SkipField(const char*& p, const char* end) {
+    const void* comma = std::memchr(p, ',', end - p);
+    p = comma ? static_cast<const char*>(comma) + 1 : end;
+}
+
+}  // namespace
+
+std::shared_ptr<const TimeSeriesFile> TimeSeriesFile::Open(const std::string& path, std::string& error) {
+    // A file is unmapped once its last mapping lets go; its entry here is
+    // dropped on the next Open(), so the cache only holds files in use
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<const TimeSeriesFile>> open_files;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = open_files.begin(); it != open_files.end();) {
+        it = it->second.expired() ? open_files.erase(it) : std::next(it);
+    }
+    auto cached = open_files.find(path);
+    if (cached != open_files.end()) {
+        if (auto shared = cached->second.lock()) {
+            return shared;
+        }
+    }
+
+    std::shared_ptr<TimeSeriesFile> file(new TimeSeriesFile());
+    file->path_ = path;
+
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "cannot open time series " + path + ": " + std::strerror(errno);
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        error = "time series " + path + " is empty";
+        return nullptr;
+    }
+    void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        error = "cannot map time series " + path + ": " + std::strerror(errno);
+        return nullptr;
+    }
+    file->data_ = static_cast<const char*>(data);
+    file->size_ = static_cast<size_t>(st.st_size);
+    madvise(data, file->size_, MADV_SEQUENTIAL);
+
+    file->binary_ = file->size_ >= sizeof(kBinaryMagic) &&
+                    std::memcmp(file->data_, kBinaryMagic, sizeof(kBinaryMagic)) == 0;
+    if (!(file->binary_ ? file->ParseBinaryHeader(error) : file->ParseCsvHeader(error))) {
+        error = "time series " + path + ": " + error;
+        return nullptr;
+    }
+
+    open_files[path] = file;
+    return file;
+}
+
+TimeSeriesFile::~TimeSeriesFile() {
+    if (data_) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+std::optional<size_t> TimeSeriesFile::column(const std::string& name) const {
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        if (columns_[i] == name) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+bool TimeSeriesFile::ParseCsvHeader(std::string& error) {
+    // Header: the first line that is neither empty nor a comment
+    size_t pos = 0;
+    const char* end = data_ + size_;
+    const char* line = data_;
+    const char* line_end = data_;
+    while (pos < size_) {
+        line = data_ + pos;
+        const void* nl = std::memchr(line, '\n', end - line);
+        line_end = nl ? static_cast<const char*>(nl) : end;
+        pos = static_cast<size_t>(line_end - data_) + 1;
+        while (line < line_end && IsBlank(*line)) {
+            ++line;
+        }
+        if (line < line_end && *line != '#') {
+            break;
+        }
+        line = line_end;
+    }
+    if (line >= line_end) {
+        error = "no header row";
+        return false;
+    }
+
+    std::vector<std::string> names;
+    const char* p = line;
+    while (p <= line_end) {
+        const void* comma = std::memchr(p, ',', line_end - p);
+        const char* field_end = comma ? static_cast<const char*>(comma) : line_end;
+        std::string name(p, field_end);
+        while (!name.empty() && (IsBlank(name.back()) || name.back() == '"')) {
+            name.pop_back();
+        }
+        size_t skip = 0;
+        while (skip < name.size() && (IsBlank(name[skip]) || name[skip] == '"')) {
+            ++skip;
+        }
+        names.push_back(name.substr(skip));
+        p = field_end + 1;
+    }
+    if (names.size() < 2) {
+        error = "needs a time column and at least one value column";
+        return false;
+    }
+    columns_.assign(names.begin() + 1, names.end());
+    first_row_ = std::min(pos, size_);
+
+    Row first;
+    size_t cursor = first_row_;
+    size_t last = 0;
+    Row final_row;
+    if (!ReadCsv(cursor, 0, first) || !FindLastCsvRow(last) || !ReadCsv(last, 0, final_row)) {
+        error = "no readable data rows";
+        return false;
+    }
+    start_time_ = first.time;
+    end_time_ = final_row.time;
+    if (end_time_ < start_time_) {
+        error = "time column decreases";
+        return false;
+    }
+    return true;
+}
+
+bool TimeSeriesFile::FindLastCsvRow(size_t& pos) const {
+    size_t line_end = size_;
+    while (line_end > first_row_) {
+        size_t line_start = line_end;
+        while (line_start > first_row_ && data_[line_start - 1] != '\n') {
+            --line_start;
+        }
+        size_t p = line_start;
+        while (p < line_end && IsBlank(data_[p])) {
+            ++p;
+        }
+        if (p < line_end && data_[p] != '\n' && data_[p] != '#') {
+            pos = line_start;
+            return true;
+        }
+        if (line_start == 0) {
+            break;
+        }
+        line_end = line_start - 1;
+    }
+    return false;
+}
+
+bool TimeSeriesFile::ReadCsv(size_t& pos, size_t column, Row& row) const {
+    const char* end = data_ + size_;
+    while (pos < size_) {
+        const char* line = data_ + pos;
+        const void* nl = std::memchr(line, '\n', end - line);
+        const char* line_end = nl ? static_cast<const char*>(nl) : end;
+        pos = static_cast<size_t>(line_end - data_) + 1;
+
+        const char* p = line;
+        while (p < line_end && IsBlank(*p)) {
+            ++p;
+        }
+        if (p == line_end || *p == '#') {
+            continue;
+        }
+        if (!ParseField(p, line_end, row.time)) {
+            return false;
+        }
+        for (size_t i = 0; i < column; ++i) {
+            SkipField(p, line_end);
+        }
+        return ParseField(p, line_end, row.value);
+    }
+    return false;
+}
+
+bool TimeSeriesFile::ParseBinaryHeader(std::string& error) {
+    if (size_ < kBinaryHeaderSize) {
+        error = "truncated header";
+        return false;
+    }
+    uint32_t version;
+    uint32_t columns;
+    uint64_t rows;
+    std::memcpy(&version, data_ + 4, sizeof(version));
+    std::memcpy(&columns, data_ + 8, sizeof(columns));
+    std::memcpy(&rows, data_ + 16, sizeof(rows));
+    if (version != kBinaryVersion) {
+        error = "unsupported binary version " + std::to_string(version);
+        return false;
+    }
+    if (columns < 2) {
+        error = "needs a time column and at least one value column";
+        return false;
+    }
+
+    size_t offset = kBinaryHeaderSize;
+    std::vector<std::string> names;
+    for (uint32_t i = 0; i < columns; ++i) {
+        uint16_t length;
+        if (offset + sizeof(length) > size_) {
+            error = "truncated column names";
+            return false;
+        }
+        std::memcpy(&length, data_ + offset, sizeof(length));
+        offset += sizeof(length);
+        if (offset + length > size_) {
+            error = "truncated column names";
+            return false;
+        }
+        names.emplace_back(data_ + offset, length);
+        offset += length;
+    }
+    offset = (offset + 7) & ~static_cast<size_t>(7);
+
+    const size_t stride = static_cast<size_t>(columns) * sizeof(double);
+    if (rows == 0 || offset > size_ || (size_ - offset) / stride < rows) {
+        error = "row data is shorter than the header says";
+        return false;
+    }
+    columns_.assign(names.begin() + 1, names.end());
+    rows_ = static_cast<size_t>(rows);
+    row_offset_ = offset;
+    first_row_ = 0;
+
+    std::memcpy(&start_time_, data_ + row_offset_, sizeof(double));
+    std::memcpy(&end_time_, data_ + row_offset_ + (rows_ - 1) * stride, sizeof(double));
+    if (end_time_ < start_time_) {
+        error = "time column decreases";
+        return false;
+    }
+    return true;
+}
+
+bool TimeSeriesFile::read(size_t& pos, size_t column, Row& row) const {
+    if (!binary_) {
+        return ReadCsv(pos, column, row);
+    }
+    if (pos >= rows_) {
+        return false;
+    }
+    const char* base = data_ + row_offset_ + pos * (columns_.size() + 1) * sizeof(double);
+    std::memcpy(&row.time, base, sizeof(double));
+    std::memcpy(&row.value, base + (column + 1) * sizeof(double), sizeof(double));
+    ++pos;
+    return true;
+}
+
+TimeSeriesCursor::TimeSeriesCursor(std::shared_ptr<const TimeSeriesFile> file, size_t column)
+    : file_(std::move(file)), column_(column) {
+    rewind();
+}
+
+void TimeSeriesCursor::rewind() {
+    next_ = file_->begin();
+    a_ = TimeSeriesFile::Row{file_->start_time(), 0.0};
+    file_->read(next_, column_, a_);
+    has_b_ = file_->read(next_, column_, b_);
+}
+
+double TimeSeriesCursor::sample(double t, bool linear) {
+    while (has_b_ && b_.time <= t) {
+        a_ = b_;
+        has_b_ = file_->read(next_, column_, b_) && b_.time >= a_.time;
+    }
+    if (!linear || !has_b_ || t <= a_.time || b_.time <= a_.time) {
+        return a_.value;
+    }
+    return a_.value + (b_.value - a_.value) * (t - a_.time) / (b_.time - a_.time);
+}
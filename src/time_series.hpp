@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * Recorded time series for playback mappings
+ *
+ * Files are memory-mapped and rows are decoded only when playback reaches
+ * them. Two formats are accepted, told apart by their first bytes:
+ *
+ *  CSV     A header row of column names, then one row per sample. The first
+ *          column is the time in seconds; it must not decrease. Empty lines
+ *          and lines starting with '#' are skipped.
+ *
+ *  Binary  "FXTS", uint32 version (1), uint32 column count (including time),
+ *          uint32 reserved, uint64 row count, then per column a uint16 name
+ *          length and the name bytes, zero padding to a multiple of 8, then
+ *          the rows as little-endian doubles, time first.
+ */
+class TimeSeriesFile {
+public:
+    struct Row {
+        double time = 0.0;
+        double value = 0.0;
+    };
+
+    // Files are shared between all mappings that play the same path
+    static std::shared_ptr<const TimeSeriesFile> Open(const std::string& path, std::string& error);
+
+    ~TimeSeriesFile();
+    TimeSeriesFile(const TimeSeriesFile&) = delete;
+    TimeSeriesFile& operator=(const TimeSeriesFile&) = delete;
+
+    const std::string& path() const { return path_; }
+    std::optional<size_t> column(const std::string& name) const;  // Value columns only, not time
+    double start_time() const { return start_time_; }
+    double end_time() const { return end_time_; }
+
+    // Position of the first row, for read()
+    size_t begin() const { return first_row_; }
+
+    // Decode the row at |pos| into |row| and advance |pos|; false at the end
+    // of the data or on a malformed row
+    bool read(size_t& pos, size_t column, Row& row) const;
+
+private:
+    TimeSeriesFile() = default;
+
+    bool ParseCsvHeader(std::string& error);
+    bool ParseBinaryHeader(std::string& error);
+    bool ReadCsv(size_t& pos, size_t column, Row& row) const;
+    bool FindLastCsvRow(size_t& pos) const;
+
+    std::string path_;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool binary_ = false;
+    std::vector<std::string> columns_;  // Value column names, excluding time
+    size_t first_row_ = 0;              // Byte offset (CSV) or row index (binary)
+    size_t rows_ = 0;                   // Binary only
+    size_t row_offset_ = 0;             // Binary only, byte offset of row 0
+    double start_time_ = 0.0;
+    double end_time_ = 0.0;
+};
+
+/**
+ * @brief Reads one column of a TimeSeriesFile forward in time
+ */
+class TimeSeriesCursor {
+public:
+    TimeSeriesCursor(std::shared_ptr<const TimeSeriesFile> file, size_t column);
+
+    // Value at file time |t|, linearly interpolated or held from the last row.
+    // |t| may only decrease after rewind().
+    double sample(double t, bool linear);
+    void rewind();
+
+    const std::shared_ptr<const TimeSeriesFile>& file() const { return file_; }
+
+private:
+    std::shared_ptr<const TimeSeriesFile> file_;
+    size_t column_;
+    size_t next_ = 0;
+    TimeSeriesFile::Row a_;
+    TimeSeriesFile::Row b_;
+    bool has_b_ = false;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief Hashed timing wheel for many coarse timeouts
+ *
+ * Deadlines are rounded up to the resolution and hashed into a ring of
+ * slots; deadlines further out than one turn wait in their slot for later
+ * turns. Scheduling is O(1) and advancing touches only the slots passed.
+ * Not thread-safe.
+ */
+class TimingWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit TimingWheel(Clock::duration resolution = std::chrono::milliseconds(10), size_t slots = 256,
+                         Clock::time_point origin = Clock::now())
+        : resolution_(resolution), origin_(origin), slots_(slots) {}
+
+    bool empty() const { return size_ == 0; }
+
+    // |id| is reported by advance() once |deadline| has passed
+    void schedule(uint32_t id, Clock::time_point deadline) {
+        int64_t tick = TickAfter(deadline);
+        if (tick <= current_) {
+            tick = current_ + 1;
+        }
+        slots_[Slot(tick)].push_back(Entry{id, tick});
+        next_ = std::min(next_, tick);
+        ++size_;
+    }
+
+    // Append the ids whose deadlines passed by |now| to |expired|
+    void advance(Clock::time_point now, std::vector<uint32_t>& expired) {
+        const int64_t target = TickBefore(now);
+        if (target <= current_) {
+            return;
+        }
+        // A gap longer than a turn visits every slot once
+        const int64_t steps = std::min<int64_t>(target - current_, static_cast<int64_t>(slots_.size()));
+        for (int64_t i = 1; i <= steps; ++i) {
+            auto& slot = slots_[Slot(current_ + i)];
+            auto keep = slot.begin();
+            for (auto& entry : slot) {
+                if (entry.tick <= target) {
+                    expired.push_back(entry.id);
+                    --size_;
+                } else {
+                    *keep++ = entry;
+                }
+            }
+            slot.erase(keep, slot.end());
+        }
+        current_ = target;
+        next_ = FindNext();
+    }
+
+    // When advance() may next have something to report
+    std::optional<Clock::time_point> next_deadline() const {
+        if (size_ == 0) {
+            return std::nullopt;
+        }
+        return origin_ + resolution_ * next_;
+    }
+
+private:
+    struct Entry {
+        uint32_t id;
+        int64_t tick;
+    };
+
+    static constexpr int64_t kNone = std::numeric_limits<int64_t>::max();
+
+    size_t Slot(int64_t tick) const { return static_cast<size_t>(tick) % slots_.size(); }
+
+    int64_t TickBefore(Clock::time_point t) const { return (t - origin_) / resolution_; }
+    int64_t TickAfter(Clock::time_point t) const {
+        const int64_t tick = TickBefore(t);
+        return origin_ + resolution_ * tick < t ? tick + 1 : tick;
+    }
+
+    // First tick after current_ whose slot holds anything (possibly a later turn's)
+    int64_t FindNext() const {
+        if (size_ == 0) {
+            return kNone;
+        }
+        for (size_t i = 1; i <= slots_.size(); ++i) {
+            if (!slots_[Slot(current_ + static_cast<int64_t>(i))].empty()) {
+                return current_ + static_cast<int64_t>(i);
+            }
+        }
+        return kNone;
+    }
+
+    Clock::duration resolution_;
+    Clock::time_point origin_;
+    std::vector<std::vector<Entry>> slots_;
+    int64_t current_ = 0;  // Last tick advanced to
+    int64_t next_ = kNone;
+    size_t size_ = 0;
+};
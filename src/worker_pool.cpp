@@ -0,0 +1,97 @@
+#include "worker_pool.hpp"
+
+#include <algorithm>
+
+WorkerPool::WorkerPool(size_t threads) : thread_count_(std::max<size_t>(1, threads)) {}
+
+WorkerPool::~WorkerPool() {
+    stop();
+}
+
+size_t WorkerPool::add(Task* task) {
+    tasks_.push_back(Entry{task});
+    return tasks_.size() - 1;
+}
+
+void WorkerPool::start() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = true;
+        const auto now = Clock::now();
+        for (size_t id = 0; id < tasks_.size(); ++id) {
+            Schedule(id, now);
+        }
+    }
+    for (size_t i = 0; i < thread_count_; ++i) {
+        threads_.emplace_back([this] { Work(); });
+    }
+}
+
+void WorkerPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+    threads_.clear();
+}
+
+void WorkerPool::wake(size_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = tasks_[id];
+    if (entry.polling) {
+        entry.woken = true;
+        return;
+    }
+    if (running_) {
+        Schedule(id, Clock::now());
+        cv_.notify_one();
+    }
+}
+
+void WorkerPool::Schedule(size_t id, Clock::time_point due) {
+    queue_.emplace(due, ++tasks_[id].generation, id);
+}
+
+void WorkerPool::Work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        // Entries superseded by a later Schedule() are dropped as they surface
+        while (!queue_.empty() && std::get<1>(queue_.top()) != tasks_[std::get<2>(queue_.top())].generation) {
+            queue_.pop();
+        }
+        if (queue_.empty()) {
+            cv_.wait(lock);
+            continue;
+        }
+        const auto [due, generation, id] = queue_.top();
+        if (due == Clock::time_point::max()) {
+            cv_.wait(lock);
+            continue;
+        }
+        if (due > Clock::now()) {
+            cv_.wait_until(lock, due);
+            continue;
+        }
+        queue_.pop();
+
+        Entry& entry = tasks_[id];
+        entry.polling = true;
+        ++entry.generation;  // A wake() meanwhile only sets |woken|
+        lock.unlock();
+        const auto next = entry.task->poll();
+        lock.lock();
+        entry.polling = false;
+        Schedule(id, entry.woken ? Clock::now() : next);
+        entry.woken = false;
+
+        // Another thread may be sleeping past this task's new deadline
+        cv_.notify_one();
+    }
+}
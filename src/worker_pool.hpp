@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+/**
+ * @brief Runs many cooperative tasks on a fixed number of threads
+ *
+ * A task's poll() does whatever is due without blocking and returns when it
+ * next wants to run. Tasks wait in a deadline queue; a task is polled by at
+ * most one thread at a time, so its state needs no locking of its own.
+ * wake() brings a task's next poll forward to now, from any thread; a wake
+ * during a poll polls the task again right after. A task with nothing
+ * scheduled returns Clock::time_point::max().
+ */
+class WorkerPool {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    class Task {
+    public:
+        virtual ~Task() = default;
+
+        virtual Clock::time_point poll() = 0;
+    };
+
+    explicit WorkerPool(size_t threads);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Before start() only; |task| must outlive the pool. Returns its id for wake().
+    size_t add(Task* task);
+
+    void start();  // Every task is polled once right away
+    void stop();   // Returns once no poll is running
+
+    void wake(size_t id);
+
+private:
+    struct Entry {
+        Task* task;
+        uint64_t generation = 0;  // Queue entries of older generations are stale
+        bool polling = false;
+        bool woken = false;
+    };
+
+    // (due, generation, id); the earliest due on top
+    using Due = std::tuple<Clock::time_point, uint64_t, size_t>;
+
+    void Schedule(size_t id, Clock::time_point due);
+    void Work();
+
+    const size_t thread_count_;
+    std::vector<Entry> tasks_;
+    std::priority_queue<Due, std::vector<Due>, std::greater<Due>> queue_;
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool running_ = false;
+};
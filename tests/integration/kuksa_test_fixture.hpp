@@ -6,8 +6,48 @@
 #include <thread>
 #include <cstdlib>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
 #include <unistd.h>
 #include <glog/logging.h>
+#include <kuksa_cpp/kuksa.hpp>
+#include <yaml-cpp/yaml.h>
+
+/**
+ * @brief Every update a subscription has delivered, recorded on the client's thread
+ *
+ * An update without a value (NOT_AVAILABLE) is recorded as nullopt.
+ */
+template <typename T>
+class ObservedSignal {
+public:
+    void record(const vss::types::QualifiedValue<T>& qv) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        values_.push_back(qv.value);
+    }
+
+    // Latest update; nullopt before the first one or if it had no value
+    std::optional<T> latest() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return values_.empty() ? std::nullopt : values_.back();
+    }
+
+    size_t updates() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return values_.size();
+    }
+
+    std::vector<std::optional<T>> values() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return values_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::optional<T>> values_;
+};
 
 /**
  * @brief Base test fixture for KUKSA integration tests
@@ -189,20 +229,207 @@ protected:
         }
       }
     }
+  },
+  "Fleet": {
+    "type": "branch",
+    "description": "Replicas served in fleet mode",
+    "children": {
+      "V0": {
+        "type": "branch",
+        "description": "Replica 0",
+        "children": {
+          "Vehicle": {
+            "type": "branch",
+            "description": "Replica vehicle",
+            "children": {
+              "Private": {
+                "type": "branch",
+                "description": "Private test signals",
+                "children": {
+                  "Test": {
+                    "type": "branch",
+                    "description": "Test signals for replicas",
+                    "children": {
+                      "Int8Actuator": {
+                        "type": "actuator",
+                        "datatype": "int8",
+                        "description": "Test int8 actuator"
+                      },
+                      "Int32Actuator": {
+                        "type": "actuator",
+                        "datatype": "int32",
+                        "description": "Test int32 actuator"
+                      },
+                      "DoubleSensor": {
+                        "type": "sensor",
+                        "datatype": "double",
+                        "description": "Test double sensor"
+                      }
+                    }
+                  }
+                }
+              }
+            }
+          }
+        }
+      },
+      "V1": {
+        "type": "branch",
+        "description": "Replica 1",
+        "children": {
+          "Vehicle": {
+            "type": "branch",
+            "description": "Replica vehicle",
+            "children": {
+              "Private": {
+                "type": "branch",
+                "description": "Private test signals",
+                "children": {
+                  "Test": {
+                    "type": "branch",
+                    "description": "Test signals for replicas",
+                    "children": {
+                      "Int8Actuator": {
+                        "type": "actuator",
+                        "datatype": "int8",
+                        "description": "Test int8 actuator"
+                      },
+                      "Int32Actuator": {
+                        "type": "actuator",
+                        "datatype": "int32",
+                        "description": "Test int32 actuator"
+                      },
+                      "DoubleSensor": {
+                        "type": "sensor",
+                        "datatype": "double",
+                        "description": "Test double sensor"
+                      }
+                    }
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
   }
 })";
         vss_file.close();
     }
 
     void SetUp() override {
-        // Per-test setup
+        auto resolver_result = kuksa::Resolver::create(getKuksaAddress());
+        ASSERT_TRUE(resolver_result.ok()) << "Failed to create resolver: " << resolver_result.status();
+        resolver_ = std::move(*resolver_result);
     }
 
     void TearDown() override {
+        if (observer_) {
+            observer_->stop();
+            observer_.reset();
+        }
+        commander_.reset();
+        resolver_.reset();
+
         // Wait for connections to close cleanly
         std::this_thread::sleep_for(std::chrono::milliseconds(200));
     }
 
+    /**
+     * @brief Subscribe to |path| on the test's observer client
+     *
+     * Subscriptions are sent when StartObserver() is called.
+     */
+    template <typename T>
+    std::shared_ptr<ObservedSignal<T>> Observe(const std::string& path) {
+        auto observed = std::make_shared<ObservedSignal<T>>();
+        auto handle = resolver_->get<T>(path);
+        EXPECT_TRUE(handle.ok()) << "Failed to resolve " << path << ": " << handle.status();
+        if (!handle.ok()) {
+            return observed;
+        }
+        if (!observer_) {
+            observer_ = std::move(*kuksa::Client::create(getKuksaAddress()));
+        }
+        observer_->subscribe(*handle, [observed](vss::types::QualifiedValue<T> qv) { observed->record(qv); });
+        return observed;
+    }
+
+    void StartObserver() {
+        ASSERT_TRUE(observer_) << "Nothing to observe";
+        observer_->start();
+        observer_->wait_until_ready(std::chrono::seconds(5));
+    }
+
+    /**
+     * @brief Set the target of actuator |path| to |value|
+     * @return false, with a test failure, if the broker refused
+     */
+    template <typename T>
+    bool Command(const std::string& path, T value) {
+        auto handle = resolver_->get<T>(path);
+        if (!handle.ok()) {
+            ADD_FAILURE() << "Failed to resolve " << path << ": " << handle.status();
+            return false;
+        }
+        if (!commander_) {
+            commander_ = std::move(*kuksa::Client::create(getKuksaAddress()));
+        }
+        auto status = commander_->set(*handle, value);
+        if (!status.ok()) {
+            ADD_FAILURE() << "Failed to command " << path << ": " << status;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief A fixture file with one fixture
+     * @param serves Served() entries
+     */
+    static YAML::Node MakeFixture(const std::string& name, const std::vector<YAML::Node>& serves,
+                                  const std::vector<YAML::Node>& mappings) {
+        YAML::Node fixture;
+        fixture["name"] = name;
+        for (const auto& served : serves) {
+            fixture["serves"].push_back(served);
+        }
+        for (const auto& mapping : mappings) {
+            fixture["mappings"].push_back(mapping);
+        }
+        YAML::Node config;
+        config["fixture"] = fixture;
+        return config;
+    }
+
+    // Served actuator entry; add accept, max_age_ms, ... to it
+    static YAML::Node Served(const std::string& signal) {
+        YAML::Node served;
+        served["signal"] = signal;
+        return served;
+    }
+
+    // Mapping of |signal| from |input| with native transform |kind|
+    static YAML::Node NativeMapping(const std::string& signal, const std::string& input,
+                                    const std::string& datatype, const std::string& kind) {
+        YAML::Node mapping = Mapping(signal, input, datatype);
+        mapping["transform"]["native"] = kind;
+        return mapping;
+    }
+
+    // Mapping of |signal| from |input| with Lua |code|; Dep() names an input
+    static YAML::Node LuaMapping(const std::string& signal, const std::string& input,
+                                 const std::string& datatype, const std::string& code) {
+        YAML::Node mapping = Mapping(signal, input, datatype);
+        mapping["transform"]["code"] = code;
+        return mapping;
+    }
+
+    static std::string Dep(const std::string& signal) {
+        return "deps['" + signal + "']";
+    }
+
     /**
      * @brief Get the KUKSA databroker address
      */
@@ -227,6 +454,20 @@ protected:
         }
         return true;
     }
+
+    std::unique_ptr<kuksa::Resolver> resolver_;
+
+private:
+    static YAML::Node Mapping(const std::string& signal, const std::string& input, const std::string& datatype) {
+        YAML::Node mapping;
+        mapping["signal"] = signal;
+        mapping["depends_on"].push_back(input);
+        mapping["datatype"] = datatype;
+        return mapping;
+    }
+
+    std::unique_ptr<kuksa::Client> observer_;
+    std::unique_ptr<kuksa::Client> commander_;
 };
 
 // Static member initialization
@@ -0,0 +1,62 @@
+/**
+ * Test plugin for the fixture plugin ABI
+ *
+ * scale: output = input * gain (param, default 2)
+ */
+
+#include <string_view>
+#include "fixture_plugin.h"
+
+namespace {
+
+struct ScaleState {
+    double gain = 2.0;
+};
+
+double AsDouble(const fixture_value& value) {
+    switch (value.type) {
+        case FIXTURE_TYPE_BOOL: return value.as.b;
+        case FIXTURE_TYPE_INT64: return static_cast<double>(value.as.i64);
+        case FIXTURE_TYPE_UINT64: return static_cast<double>(value.as.u64);
+        default: return value.as.f64;
+    }
+}
+
+}  // namespace
+
+extern "C" {
+
+uint32_t fixture_plugin_abi_version(void) {
+    return FIXTURE_PLUGIN_ABI_VERSION;
+}
+
+void* scale_create(const fixture_param* params, size_t param_count) {
+    auto* state = new ScaleState();
+    for (size_t i = 0; i < param_count; ++i) {
+        if (std::string_view(params[i].key) == "gain") {
+            state->gain = params[i].value;
+        }
+    }
+    return state;
+}
+
+void scale_destroy(void* state) {
+    delete static_cast<ScaleState*>(state);
+}
+
+int scale(fixture_call* call) {
+    if (call->input_count != 1 || !call->changed[0]) {
+        return FIXTURE_NO_OUTPUT;
+    }
+    const auto* state = static_cast<const ScaleState*>(call->state);
+    const double y = AsDouble(call->inputs[0]) * state->gain;
+    switch (call->output->type) {
+        case FIXTURE_TYPE_BOOL: call->output->as.b = y != 0.0; break;
+        case FIXTURE_TYPE_INT64: call->output->as.i64 = static_cast<int64_t>(y); break;
+        case FIXTURE_TYPE_UINT64: call->output->as.u64 = static_cast<uint64_t>(y); break;
+        default: call->output->as.f64 = y; break;
+    }
+    return FIXTURE_OUTPUT;
+}
+
+}  // extern "C"
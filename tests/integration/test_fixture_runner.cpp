@@ -16,10 +16,14 @@
 #include <chrono>
 #include <memory>
 #include <fstream>
+#include <vector>
 #include <yaml-cpp/yaml.h>
 #include <signal.h>
+#include <sysexits.h>
 #include <sys/wait.h>
 #include <unistd.h>
+#include "capture.hpp"
+#include "gorilla.hpp"
 #include "kuksa_test_fixture.hpp"
 
 using namespace kuksa;
@@ -42,11 +46,6 @@ protected:
     void SetUp() override {
         KuksaTestFixture::SetUp();
 
-        // Create resolver
-        auto resolver_result = Resolver::create(getKuksaAddress());
-        ASSERT_TRUE(resolver_result.ok()) << "Failed to create resolver: " << resolver_result.status();
-        resolver_ = std::move(*resolver_result);
-
         // Create test fixtures config file
         fixtures_config_path_ = "/tmp/test_fixtures.yaml";
     }
@@ -59,8 +58,6 @@ protected:
             unlink(fixtures_config_path_.c_str());
         }
 
-        resolver_.reset();
-
         // Give databroker time to release provider registrations
         // When a provider disconnects, the databroker needs time to clean up
         std::this_thread::sleep_for(std::chrono::milliseconds(500));
@@ -70,9 +67,11 @@ protected:
 
     /**
      * @brief Create a fixtures configuration file
+     *
+     * @param path defaults to the file passed with --config
      */
-    void CreateFixturesConfig(const YAML::Node& fixtures) {
-        std::ofstream file(fixtures_config_path_);
+    void CreateFixturesConfig(const YAML::Node& fixtures, const std::string& path = "") {
+        std::ofstream file(path.empty() ? fixtures_config_path_ : path);
         ASSERT_TRUE(file.is_open()) << "Failed to create fixtures config file";
         file << fixtures;
         file.close();
@@ -80,28 +79,17 @@ protected:
 
     /**
      * @brief Start the fixture-runner binary as subprocess
+     *
+     * @param extra_args appended after --kuksa and --config
      */
-    void StartFixtureRunner() {
+    void StartFixtureRunner(const std::vector<std::string>& extra_args = {}) {
         LOG(INFO) << "Starting fixture-runner subprocess...";
 
         fixture_runner_pid_ = fork();
         ASSERT_GE(fixture_runner_pid_, 0) << "Failed to fork process";
 
         if (fixture_runner_pid_ == 0) {
-            // Child process - exec fixture-runner
-            std::string binary_path = std::string(BUILD_DIR) + "/fixture-runner";
-            const char* args[] = {
-                binary_path.c_str(),
-                "--kuksa", getKuksaAddress().c_str(),
-                "--config", fixtures_config_path_.c_str(),
-                nullptr
-            };
-
-            execv(binary_path.c_str(), const_cast<char* const*>(args));
-
-            // If we get here, exec failed
-            LOG(ERROR) << "Failed to exec fixture-runner: " << strerror(errno);
-            exit(1);
+            ExecFixtureRunner(extra_args);
         }
 
         // Parent process - wait for fixture-runner to start
@@ -127,25 +115,79 @@ protected:
     }
 
     /**
-     * @brief Stop the fixture-runner subprocess
+     * @brief Run the fixture-runner binary until it exits
+     *
+     * @return its exit code, or -1 if it did not exit normally
+     */
+    int RunFixtureRunnerToExit(const std::vector<std::string>& extra_args) {
+        const pid_t pid = fork();
+        if (pid == 0) {
+            ExecFixtureRunner(extra_args);
+        }
+        int status;
+        if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status)) {
+            return -1;
+        }
+        return WEXITSTATUS(status);
+    }
+
+    /**
+     * @brief Stop the fixture-runner subprocess with SIGTERM
+     *
+     * @return its exit code, or -1 if it was not running or did not exit normally
      */
-    void StopFixtureRunner() {
+    int StopFixtureRunner() {
+        int exit_code = -1;
         if (fixture_runner_pid_ > 0) {
             LOG(INFO) << "Stopping fixture-runner (PID: " << fixture_runner_pid_ << ")...";
             kill(fixture_runner_pid_, SIGTERM);
 
             // Wait for process to exit
             int status;
-            waitpid(fixture_runner_pid_, &status, 0);
+            if (waitpid(fixture_runner_pid_, &status, 0) == fixture_runner_pid_ && WIFEXITED(status)) {
+                exit_code = WEXITSTATUS(status);
+            }
 
             fixture_runner_pid_ = -1;
             LOG(INFO) << "Fixture-runner stopped";
         }
+        return exit_code;
+    }
+
+    // Lua delayed() mirror of an int8 actuator, for the tick tests. delayed()
+    // only emits on a pass after its delay has passed.
+    static constexpr const char* kDelayedMirrorInput = "Vehicle.Private.Test.Int8Actuator";
+    static constexpr const char* kDelayedMirrorOutput = "Vehicle.Private.Test.Int32Actuator";
+    static YAML::Node DelayedMirrorFixture(const std::string& name) {
+        return MakeFixture(name, {Served(kDelayedMirrorInput)},
+                           {LuaMapping(kDelayedMirrorOutput, kDelayedMirrorInput, "int32",
+                                       "delayed(" + Dep(kDelayedMirrorInput) + ", 300)")});
     }
 
-    std::unique_ptr<Resolver> resolver_;
     std::string fixtures_config_path_;
     pid_t fixture_runner_pid_ = -1;
+
+private:
+    // In a forked child: replace it with fixture-runner
+    [[noreturn]] void ExecFixtureRunner(const std::vector<std::string>& extra_args) {
+        std::string binary_path = std::string(BUILD_DIR) + "/fixture-runner";
+        const std::string kuksa_address = getKuksaAddress();
+        std::vector<const char*> args = {
+            binary_path.c_str(),
+            "--kuksa", kuksa_address.c_str(),
+            "--config", fixtures_config_path_.c_str(),
+        };
+        for (const auto& arg : extra_args) {
+            args.push_back(arg.c_str());
+        }
+        args.push_back(nullptr);
+
+        execv(binary_path.c_str(), const_cast<char* const*>(args.data()));
+
+        // If we get here, exec failed
+        LOG(ERROR) << "Failed to exec fixture-runner: " << strerror(errno);
+        exit(1);
+    }
 };
 
 /**
@@ -545,6 +587,832 @@ TEST_F(FixtureRunnerIntegrationTest, FixtureCrossSignalEffect) {
     observer->stop();
 }
 
+/**
+ * @brief Test: Native delayed transform mirrors the command without Lua
+ */
+TEST_F(FixtureRunnerIntegrationTest, FixtureNativeDelayedMirror) {
+    YAML::Node config;
+    YAML::Node fixture;
+    fixture["name"] = "Native Door Fixture";
+
+    fixture["serves"].push_back(TEST_DOOR_ACTUATOR);
+
+    YAML::Node mapping;
+    mapping["signal"] = TEST_DOOR_ACTUATOR;
+    mapping["depends_on"].push_back(TEST_DOOR_ACTUATOR);
+    mapping["datatype"] = "boolean";
+    mapping["transform"]["native"] = "delayed";
+    mapping["transform"]["delay_ms"] = 200;
+    fixture["mappings"].push_back(mapping);
+
+    config["fixture"] = fixture;
+    CreateFixturesConfig(config);
+
+    auto door_handle = *resolver_->get<bool>(TEST_DOOR_ACTUATOR);
+
+    auto observer = std::move(*Client::create(getKuksaAddress()));
+    std::atomic<int> update_count(0);
+    std::atomic<bool> last_value(true);
+
+    observer->subscribe(door_handle, [&](vss::types::QualifiedValue<bool> qv) {
+        if (qv.value.has_value()) {
+            last_value = *qv.value;
+            update_count++;
+        }
+    });
+
+    observer->start();
+    observer->wait_until_ready(std::chrono::seconds(5));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    int initial_count = update_count.load();
+
+    StartFixtureRunner();
+
+    auto commander = std::move(*Client::create(getKuksaAddress()));
+    auto status = commander->set(door_handle, false);
+    ASSERT_TRUE(status.ok()) << "Failed to send actuation: " << status;
+
+    ASSERT_TRUE(wait_for([&]() { return update_count.load() > initial_count; }, std::chrono::seconds(5)))
+        << "Native mapping did not publish actual value";
+    EXPECT_FALSE(last_value.load()) << "Native mapping published incorrect actual value";
+
+    observer->stop();
+}
+
+/**
+ * @brief Test: Plugin transform computes a cross-signal effect natively
+ */
+TEST_F(FixtureRunnerIntegrationTest, FixturePluginTransform) {
+    constexpr const char* ACTUATOR_SIGNAL = "Vehicle.Private.Test.Int8Actuator";
+    constexpr const char* AFFECTED_SIGNAL = "Vehicle.Private.Test.Int32Actuator";
+
+    YAML::Node config;
+    YAML::Node fixture;
+    fixture["name"] = "Plugin Test Fixture";
+
+    fixture["serves"].push_back(ACTUATOR_SIGNAL);
+    fixture["serves"].push_back(AFFECTED_SIGNAL);
+
+    // Int32 = Int8 * 3 through the scale_plugin test library
+    YAML::Node mapping;
+    mapping["signal"] = AFFECTED_SIGNAL;
+    mapping["depends_on"].push_back(ACTUATOR_SIGNAL);
+    mapping["datatype"] = "int32";
+    mapping["transform"]["plugin"] = SCALE_PLUGIN_PATH;
+    mapping["transform"]["fn"] = "scale";
+    mapping["transform"]["params"]["gain"] = 3;
+    fixture["mappings"].push_back(mapping);
+
+    config["fixture"] = fixture;
+    CreateFixturesConfig(config);
+
+    auto actuator_handle = *resolver_->get<int8_t>(ACTUATOR_SIGNAL);
+    auto affected_handle = *resolver_->get<int32_t>(AFFECTED_SIGNAL);
+
+    auto observer = std::move(*Client::create(getKuksaAddress()));
+    std::atomic<int> affected_updates(0);
+    std::atomic<int32_t> affected_value(0);
+
+    observer->subscribe(affected_handle, [&](vss::types::QualifiedValue<int32_t> qv) {
+        if (qv.value.has_value()) {
+            affected_value = *qv.value;
+            affected_updates++;
+        }
+    });
+
+    observer->start();
+    observer->wait_until_ready(std::chrono::seconds(5));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    int initial_affected = affected_updates.load();
+
+    StartFixtureRunner();
+
+    auto commander = std::move(*Client::create(getKuksaAddress()));
+    auto status = commander->set(actuator_handle, static_cast<int8_t>(14));
+    ASSERT_TRUE(status.ok()) << "Failed to send actuation: " << status;
+
+    ASSERT_TRUE(wait_for([&]() { return affected_updates.load() > initial_affected; }, std::chrono::seconds(5)))
+        << "Plugin transform did not publish within timeout";
+    EXPECT_EQ(affected_value.load(), 42);
+
+    observer->stop();
+}
+
+/**
+ * @brief Test: Native lowpass filter primes on the first command and smooths later ones
+ */
+TEST_F(FixtureRunnerIntegrationTest, FixtureNativeLowpassFilter) {
+    constexpr const char* ACTUATOR_SIGNAL = "Vehicle.Private.Test.Int8Actuator";
+    constexpr const char* FILTERED_SIGNAL = "Vehicle.Private.Test.Int32Actuator";
+
+    YAML::Node config;
+    YAML::Node fixture;
+    fixture["name"] = "Native Filter Fixture";
+
+    fixture["serves"].push_back(ACTUATOR_SIGNAL);
+
+    YAML::Node mapping;
+    mapping["signal"] = FILTERED_SIGNAL;
+    mapping["depends_on"].push_back(ACTUATOR_SIGNAL);
+    mapping["datatype"] = "int32";
+    mapping["transform"]["native"] = "lowpass";
+    mapping["transform"]["alpha"] = 0.5;
+    fixture["mappings"].push_back(mapping);
+
+    config["fixture"] = fixture;
+    CreateFixturesConfig(config);
+
+    auto actuator_handle = *resolver_->get<int8_t>(ACTUATOR_SIGNAL);
+    auto filtered_handle = *resolver_->get<int32_t>(FILTERED_SIGNAL);
+
+    auto observer = std::move(*Client::create(getKuksaAddress()));
+    std::atomic<int32_t> filtered_value(0);
+
+    observer->subscribe(filtered_handle, [&](vss::types::QualifiedValue<int32_t> qv) {
+        if (qv.value.has_value()) {
+            filtered_value = *qv.value;
+        }
+    });
+
+    observer->start();
+    observer->wait_until_ready(std::chrono::seconds(5));
+
+    StartFixtureRunner();
+
+    auto commander = std::move(*Client::create(getKuksaAddress()));
+    auto status = commander->set(actuator_handle, static_cast<int8_t>(10));
+    ASSERT_TRUE(status.ok()) << "Failed to send actuation: " << status;
+    ASSERT_TRUE(wait_for([&]() { return filtered_value.load() == 10; }, std::chrono::seconds(5)))
+        << "First sample did not prime the filter, got " << filtered_value.load();
+
+    status = commander->set(actuator_handle, static_cast<int8_t>(30));
+    ASSERT_TRUE(status.ok()) << "Failed to send actuation: " << status;
+    ASSERT_TRUE(wait_for([&]() { return filtered_value.load() == 20; }, std::chrono::seconds(5)))
+        << "Filter did not smooth the second sample, got " << filtered_value.load();
+
+    observer->stop();
+}
+
+/**
+ * @brief Test: Playback mapping publishes values from a recorded CSV file
+ */
+TEST_F(FixtureRunnerIntegrationTest, FixturePlaybackSource) {
+    constexpr const char* PLAYBACK_SIGNAL = "Vehicle.Private.Test.Int32Actuator";
+    const std::string csv_path = "/tmp/test_playback.csv";
+    {
+        std::ofstream csv(csv_path);
+        csv << "time,value\n0,40\n0.5,44\n";
+    }
+
+    YAML::Node config;
+    YAML::Node fixture;
+    fixture["name"] = "Playback Fixture";
+    fixture["serves"] = YAML::Node(YAML::NodeType::Sequence);
+
+    YAML::Node mapping;
+    mapping["signal"] = PLAYBACK_SIGNAL;
+    mapping["datatype"] = "int32";
+    mapping["transform"]["native"] = "playback";
+    mapping["transform"]["file"] = csv_path;
+    mapping["transform"]["column"] = "value";
+    mapping["transform"]["rate_hz"] = 20;
+    fixture["mappings"].push_back(mapping);
+
+    config["fixture"] = fixture;
+    CreateFixturesConfig(config);
+
+    auto playback_handle = *resolver_->get<int32_t>(PLAYBACK_SIGNAL);
+
+    auto observer = std::move(*Client::create(getKuksaAddress()));
+    std::atomic<int32_t> last_value(0);
+    std::atomic<bool> saw_start(false);
+
+    observer->subscribe(playback_handle, [&](vss::types::QualifiedValue<int32_t> qv) {
+        if (qv.value.has_value()) {
+            last_value = *qv.value;
+            if (*qv.value >= 40 && *qv.value < 44) {
+                saw_start = true;
+            }
+        }
+    });
+
+    observer->start();
+    observer->wait_until_ready(std::chrono::seconds(5));
+
+    StartFixtureRunner();
+
+    ASSERT_TRUE(wait_for([&]() { return last_value.load() == 44; }, std::chrono::seconds(5)))
+        << "Playback did not reach the last recorded value, got " << last_value.load();
+    EXPECT_TRUE(saw_start.load()) << "Playback did not publish the interpolated ramp";
+
+    observer->stop();
+    unlink(csv_path.c_str());
+}
+
+/**
+ * @brief Test: Immediately acknowledged commands are still applied in order,
+ * each one, even when a burst of them is evaluated together
+ */
+TEST_F(FixtureRunnerIntegrationTest, FixtureImmediateAck) {
+    constexpr const char* ACTUATOR_SIGNAL = "Vehicle.Private.Test.Int8Actuator";
+    constexpr const char* MIRROR_SIGNAL = "Vehicle.Private.Test.Int32Actuator";
+    constexpr const char* AVERAGE_SIGNAL = "Vehicle.Private.Test.DoubleSensor";
+
+    YAML::Node config;
+    YAML::Node fixture;
+    fixture["name"] = "Immediate Ack Fixture";
+
+    YAML::Node served;
+    served["signal"] = ACTUATOR_SIGNAL;
+    served["ack"] = "immediate";
+    fixture["serves"].push_back(served);
+
+    YAML::Node mapping;
+    mapping["signal"] = MIRROR_SIGNAL;
+    mapping["depends_on"].push_back(ACTUATOR_SIGNAL);
+    mapping["datatype"] = "int32";
+    mapping["transform"]["native"] = "copy";
+    fixture["mappings"].push_back(mapping);
+
+    // The mean depends on every sample, so it shows a command merged away
+    YAML::Node average;
+    average["signal"] = AVERAGE_SIGNAL;
+    average["depends_on"].push_back(ACTUATOR_SIGNAL);
+    average["datatype"] = "double";
+    average["transform"]["native"] = "moving_average";
+    average["transform"]["window"] = 50;
+    fixture["mappings"].push_back(average);
+
+    config["fixture"] = fixture;
+    CreateFixturesConfig(config);
+
+    auto actuator_handle = *resolver_->get<int8_t>(ACTUATOR_SIGNAL);
+    auto mirror_handle = *resolver_->get<int32_t>(MIRROR_SIGNAL);
+    auto average_handle = *resolver_->get<double>(AVERAGE_SIGNAL);
+
+    auto observer = std::move(*Client::create(getKuksaAddress()));
+    std::atomic<int32_t> mirror_value(-1);
+    std::atomic<double> average_value(0.0);
+
+    observer->subscribe(mirror_handle, [&](vss::types::QualifiedValue<int32_t> qv) {
+        if (qv.value.has_value()) {
+            mirror_value = *qv.value;
+        }
+    });
+    observer->subscribe(average_handle, [&](vss::types::QualifiedValue<double> qv) {
+        if (qv.value.has_value()) {
+            average_value = *qv.value;
+        }
+    });
+
+    observer->start();
+    observer->wait_until_ready(std::chrono::seconds(5));
+
+    StartFixtureRunner();
+
+    auto commander = std::move(*Client::create(getKuksaAddress()));
+    for (int8_t i = 1; i <= 50; ++i) {
+        auto status = commander->set(actuator_handle, i);
+        ASSERT_TRUE(status.ok()) << "Failed to send actuation " << static_cast<int>(i) << ": " << status;
+    }
+
+    ASSERT_TRUE(wait_for([&]() { return mirror_value.load() == 50; }, std::chrono::seconds(5)))
+        << "Last command was not applied, got " << mirror_value.load();
+    // Mean of 1..50: every command was evaluated, none merged with the next
+    ASSERT_TRUE(wait_for([&]() { return average_value.load() == 25.5; }, std::chrono::seconds(5)))
+        << "Moving average missed commands, got " << average_value.load();
+
+    observer->stop();
+}
+
+/**
+ * @brief Test: SIGTERM shuts the runner down cleanly and seals the capture
+ */
+TEST_F(FixtureRunnerIntegrationTest, FixtureCaptureOnShutdown) {
+    constexpr const char* ACTUATOR_SIGNAL = "Vehicle.Private.Test.Int8Actuator";
+    constexpr const char* MIRROR_SIGNAL = "Vehicle.Private.Test.Int32Actuator";
+    const std::string capture_path = "/tmp/test_fixture_capture.fxcap";
+    unlink(capture_path.c_str());
+
+    YAML::Node config;
+    YAML::Node fixture;
+    fixture["name"] = "Capture Fixture";
+    fixture["serves"].push_back(ACTUATOR_SIGNAL);
+
+    YAML::Node mapping;
+    mapping["signal"] = MIRROR_SIGNAL;
+    mapping["depends_on"].push_back(ACTUATOR_SIGNAL);
+    mapping["datatype"] = "int32";
+    mapping["transform"]["native"] = "copy";
+    fixture["mappings"].push_back(mapping);
+
+    config["fixture"] = fixture;
+    CreateFixturesConfig(config);
+
+    StartFixtureRunner({"--capture", capture_path});
+
+    // Each set() returns once its output is published, well within the
+    // capture's flush interval, so only the shutdown flush writes them
+    auto actuator_handle = *resolver_->get<int8_t>(ACTUATOR_SIGNAL);
+    auto commander = std::move(*Client::create(getKuksaAddress()));
+    for (int8_t i = 1; i <= 5; ++i) {
+        auto status = commander->set(actuator_handle, i);
+        ASSERT_TRUE(status.ok()) << "Failed to send actuation " << static_cast<int>(i) << ": " << status;
+    }
+
+    EXPECT_EQ(StopFixtureRunner(), 0) << "Runner did not exit cleanly on SIGTERM";
+
+    CaptureReader reader(capture_path);
+    ASSERT_TRUE(reader.error().empty()) << reader.error();
+    std::vector<double> mirrored;
+    CaptureReader::Chunk chunk;
+    while (reader.next(chunk)) {
+        if (*chunk.signal != MIRROR_SIGNAL) {
+            continue;
+        }
+        GorillaDecoder decoder(chunk.bytes.data(), chunk.bytes.size(), chunk.count);
+        int64_t t;
+        double value;
+        while (decoder.next(t, value)) {
+            mirrored.push_back(value);
+        }
+    }
+    EXPECT_TRUE(reader.error().empty()) << reader.error();
+    EXPECT_EQ(mirrored, (std::vector<double>{1, 2, 3, 4, 5}));
+
+    unlink(capture_path.c_str());
+}
+
+/**
+ * @brief Test: fixture-diff finds two captured runs of the same commands
+ * equivalent, and runs of different commands diverging
+ */
+TEST_F(FixtureRunnerIntegrationTest, FixtureDiffRoundTrip) {
+    constexpr const char* ACTUATOR_SIGNAL = "Vehicle.Private.Test.Int8Actuator";
+    constexpr const char* MIRROR_SIGNAL = "Vehicle.Private.Test.Int32Actuator";
+
+    YAML::Node config;
+    YAML::Node fixture;
+    fixture["name"] = "Diff Fixture";
+    fixture["serves"].push_back(ACTUATOR_SIGNAL);
+
+    YAML::Node mapping;
+    mapping["signal"] = MIRROR_SIGNAL;
+    mapping["depends_on"].push_back(ACTUATOR_SIGNAL);
+    mapping["datatype"] = "int32";
+    mapping["transform"]["native"] = "copy";
+    fixture["mappings"].push_back(mapping);
+
+    config["fixture"] = fixture;
+    CreateFixturesConfig(config);
+
+    auto actuator_handle = *resolver_->get<int8_t>(ACTUATOR_SIGNAL);
+
+    // Commands well apart compared to the pairing window used below
+    auto capture_run = [&](const std::string& path, const std::vector<int8_t>& commands) {
+        unlink(path.c_str());
+        StartFixtureRunner({"--capture", path});
+        auto commander = std::move(*Client::create(getKuksaAddress()));
+        for (int8_t command : commands) {
+            auto status = commander->set(actuator_handle, command);
+            ASSERT_TRUE(status.ok()) << "Failed to send actuation " << static_cast<int>(command) << ": " << status;
+            std::this_thread::sleep_for(std::chrono::milliseconds(400));
+        }
+        ASSERT_EQ(StopFixtureRunner(), 0) << "Runner did not exit cleanly on SIGTERM";
+    };
+    auto diff = [](const std::string& first, const std::string& second) {
+        const std::string binary_path = std::string(BUILD_DIR) + "/fixture-diff";
+        const pid_t pid = fork();
+        if (pid == 0) {
+            execl(binary_path.c_str(), binary_path.c_str(), first.c_str(), second.c_str(), "--time-tolerance-ms",
+                  "150", static_cast<char*>(nullptr));
+            _exit(127);
+        }
+        int status;
+        if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status)) {
+            return -1;
+        }
+        return WEXITSTATUS(status);
+    };
+
+    const std::string first = "/tmp/test_fixture_diff_1.fxcap";
+    const std::string second = "/tmp/test_fixture_diff_2.fxcap";
+    const std::string third = "/tmp/test_fixture_diff_3.fxcap";
+    capture_run(first, {1, 2, 3, 4});
+    capture_run(second, {1, 2, 3, 4});
+    capture_run(third, {1, 2, 7, 4});
+
+    EXPECT_EQ(diff(first, second), 0) << "Runs of the same commands diverge";
+    EXPECT_EQ(diff(first, third), 1) << "Runs of different commands compare equivalent";
+
+    unlink(first.c_str());
+    unlink(second.c_str());
+    unlink(third.c_str());
+}
+
+/**
+ * @brief Test: --seed repeats a run's noise exactly, and another seed changes it
+ */
+TEST_F(FixtureRunnerIntegrationTest, FixtureSeedReproducible) {
+    constexpr const char* ACTUATOR_SIGNAL = "Vehicle.Private.Test.Int8Actuator";
+    constexpr const char* NOISY_SIGNAL = "Vehicle.Private.Test.DoubleSensor";
+
+    YAML::Node config;
+    YAML::Node fixture;
+    fixture["name"] = "Seeded Noise Fixture";
+    fixture["serves"].push_back(ACTUATOR_SIGNAL);
+
+    YAML::Node mapping;
+    mapping["signal"] = NOISY_SIGNAL;
+    mapping["depends_on"].push_back(ACTUATOR_SIGNAL);
+    mapping["datatype"] = "double";
+    mapping["transform"]["native"] = "noise";
+    mapping["transform"]["stddev"] = 5.0;
+    fixture["mappings"].push_back(mapping);
+
+    config["fixture"] = fixture;
+    CreateFixturesConfig(config);
+
+    auto actuator_handle = *resolver_->get<int8_t>(ACTUATOR_SIGNAL);
+
+    // The noisy values published for the same three commands, read back from a capture
+    auto noisy_run = [&](const std::string& seed) {
+        const std::string capture_path = "/tmp/test_fixture_seed.fxcap";
+        unlink(capture_path.c_str());
+        StartFixtureRunner({"--capture", capture_path, "--seed", seed});
+        auto commander = std::move(*Client::create(getKuksaAddress()));
+        for (int8_t i = 1; i <= 3; ++i) {
+            auto status = commander->set(actuator_handle, i);
+            EXPECT_TRUE(status.ok()) << "Failed to send actuation " << static_cast<int>(i) << ": " << status;
+        }
+        EXPECT_EQ(StopFixtureRunner(), 0) << "Runner did not exit cleanly on SIGTERM";
+
+        std::vector<double> values;
+        CaptureReader reader(capture_path);
+        CaptureReader::Chunk chunk;
+        while (reader.next(chunk)) {
+            if (*chunk.signal != NOISY_SIGNAL) {
+                continue;
+            }
+            GorillaDecoder decoder(chunk.bytes.data(), chunk.bytes.size(), chunk.count);
+            int64_t t;
+            double value;
+            while (decoder.next(t, value)) {
+                values.push_back(value);
+            }
+        }
+        EXPECT_TRUE(reader.error().empty()) << reader.error();
+        unlink(capture_path.c_str());
+        return values;
+    };
+
+    const auto first = noisy_run("7");
+    const auto repeated = noisy_run("7");
+    const auto reseeded = noisy_run("8");
+    ASSERT_EQ(first.size(), 3u);
+    EXPECT_EQ(first, repeated) << "The same seed drew different noise";
+    EXPECT_NE(first, reseeded) << "A different seed drew the same noise";
+}
+
+/**
+ * @brief Test: Commands outside the accept range never reach the mappings
+ */
+TEST_F(FixtureRunnerIntegrationTest, FixtureAcceptRules) {
+    constexpr const char* ACTUATOR_SIGNAL = "Vehicle.Private.Test.Int8Actuator";
+    constexpr const char* MIRROR_SIGNAL = "Vehicle.Private.Test.Int32Actuator";
+
+    YAML::Node served = Served(ACTUATOR_SIGNAL);
+    served["accept"]["min"] = 0;
+    served["accept"]["max"] = 100;
+    CreateFixturesConfig(MakeFixture("Accept Rules Fixture", {served},
+                                     {NativeMapping(MIRROR_SIGNAL, ACTUATOR_SIGNAL, "int32", "copy")}));
+
+    auto mirror = Observe<int32_t>(MIRROR_SIGNAL);
+    StartObserver();
+    StartFixtureRunner();
+
+    ASSERT_TRUE(Command(ACTUATOR_SIGNAL, int8_t{120}));
+    ASSERT_TRUE(Command(ACTUATOR_SIGNAL, int8_t{20}));
+
+    ASSERT_TRUE(wait_for([&]() { return mirror->latest() == 20; }, std::chrono::seconds(5)))
+        << "Accepted command was not applied";
+    for (const auto& value : mirror->values()) {
+        EXPECT_FALSE(value && *value > 100) << "Out-of-range command reached the mapping: " << *value;
+    }
+}
+
+/**
+ * @brief Test: Two fixture files served by one process over a shared connection
+ */
+TEST_F(FixtureRunnerIntegrationTest, FixtureMultipleConfigs) {
+    constexpr const char* FIRST_ACTUATOR = "Vehicle.Private.Test.Int8Actuator";
+    constexpr const char* SECOND_ACTUATOR = "Vehicle.Private.Test.Int32Actuator";
+    const std::string second_config_path = "/tmp/test_fixtures_2.yaml";
+
+    YAML::Node first = MakeFixture("First Fixture", {Served(FIRST_ACTUATOR)},
+                                   {NativeMapping(FIRST_ACTUATOR, FIRST_ACTUATOR, "int8", "copy")});
+    YAML::Node second = MakeFixture("Second Fixture", {Served(SECOND_ACTUATOR)},
+                                    {NativeMapping(SECOND_ACTUATOR, SECOND_ACTUATOR, "int32", "copy")});
+    first["fixture"]["broker"] = getKuksaAddress();
+    second["fixture"]["broker"] = getKuksaAddress();
+    CreateFixturesConfig(first);
+    CreateFixturesConfig(second, second_config_path);
+
+    auto first_value = Observe<int8_t>(FIRST_ACTUATOR);
+    auto second_value = Observe<int32_t>(SECOND_ACTUATOR);
+    StartObserver();
+    StartFixtureRunner({"--config", second_config_path});
+
+    ASSERT_TRUE(Command(FIRST_ACTUATOR, int8_t{7}));
+    ASSERT_TRUE(Command(SECOND_ACTUATOR, int32_t{1234}));
+
+    EXPECT_TRUE(wait_for([&]() { return first_value->latest() == 7; }, std::chrono::seconds(5)))
+        << "First fixture did not publish";
+    EXPECT_TRUE(wait_for([&]() { return second_value->latest() == 1234; }, std::chrono::seconds(5)))
+        << "Second fixture did not publish";
+
+    unlink(second_config_path.c_str());
+}
+
+/**
+ * @brief Test: A fixture with Lua mappings ticks by default, so delayed() outputs arrive without further commands
+ */
+TEST_F(FixtureRunnerIntegrationTest, FixtureTicksDelayedOutput) {
+    CreateFixturesConfig(DelayedMirrorFixture("Ticking Fixture"));
+
+    auto delayed = Observe<int32_t>(kDelayedMirrorOutput);
+    StartObserver();
+    StartFixtureRunner();
+
+    const auto sent = std::chrono::steady_clock::now();
+    ASSERT_TRUE(Command(kDelayedMirrorInput, int8_t{41}));
+    ASSERT_TRUE(wait_for([&]() { return delayed->latest() == 41; }, std::chrono::seconds(3)))
+        << "Delayed output did not arrive on a tick";
+    EXPECT_GE(std::chrono::steady_clock::now() - sent, std::chrono::milliseconds(250))
+        << "Delayed output arrived before its delay";
+}
+
+/**
+ * @brief Test: tick_hz: 0 stops ticks, so delayed() outputs wait for the next pass
+ */
+TEST_F(FixtureRunnerIntegrationTest, FixtureTicksDisabled) {
+    YAML::Node config = DelayedMirrorFixture("Tickless Fixture");
+    config["fixture"]["tick_hz"] = 0;
+    CreateFixturesConfig(config);
+
+    auto delayed = Observe<int32_t>(kDelayedMirrorOutput);
+    StartObserver();
+    StartFixtureRunner();
+
+    ASSERT_TRUE(Command(kDelayedMirrorInput, int8_t{42}));
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    EXPECT_NE(delayed->latest(), 42) << "Delayed output published without a tick";
+
+    // The same command again runs a pass after the delay, which releases it:
+    // the mapping works, only the tick was missing
+    ASSERT_TRUE(Command(kDelayedMirrorInput, int8_t{42}));
+    EXPECT_TRUE(wait_for([&]() { return delayed->latest() == 42; }, std::chrono::seconds(3)))
+        << "Delayed output did not arrive with the next command";
+}
+
+/**
+ * @brief Test: Replicas of a fixture share the pool yet serve and draw noise independently
+ */
+TEST_F(FixtureRunnerIntegrationTest, FixtureReplicas) {
+    constexpr const char* ACTUATOR_SIGNAL = "Vehicle.Private.Test.Int8Actuator";
+    constexpr const char* MIRROR_SIGNAL = "Vehicle.Private.Test.Int32Actuator";
+    constexpr const char* NOISY_SIGNAL = "Vehicle.Private.Test.DoubleSensor";
+
+    YAML::Node noisy = NativeMapping(NOISY_SIGNAL, ACTUATOR_SIGNAL, "double", "noise");
+    noisy["transform"]["stddev"] = 5.0;
+    YAML::Node config = MakeFixture("Replicated Fixture", {Served(ACTUATOR_SIGNAL)},
+                                    {NativeMapping(MIRROR_SIGNAL, ACTUATOR_SIGNAL, "int32", "copy"), noisy});
+    config["fixture"]["replicas"] = 2;
+    config["fixture"]["replica"]["prefix"] = "Fleet.V{n}.";
+    CreateFixturesConfig(config);
+
+    const std::string prefixes[2] = {"Fleet.V0.", "Fleet.V1."};
+    std::shared_ptr<ObservedSignal<int32_t>> mirrored[2];
+    std::shared_ptr<ObservedSignal<double>> noise[2];
+    for (int n = 0; n < 2; ++n) {
+        mirrored[n] = Observe<int32_t>(prefixes[n] + MIRROR_SIGNAL);
+        noise[n] = Observe<double>(prefixes[n] + NOISY_SIGNAL);
+    }
+    StartObserver();
+
+    // One pool thread evaluates both replicas
+    StartFixtureRunner({"--workers", "1"});
+
+    ASSERT_TRUE(Command(prefixes[0] + ACTUATOR_SIGNAL, int8_t{11}));
+    ASSERT_TRUE(Command(prefixes[1] + ACTUATOR_SIGNAL, int8_t{22}));
+    EXPECT_TRUE(wait_for([&]() { return mirrored[0]->latest() == 11; }, std::chrono::seconds(5)))
+        << "Replica 0 did not publish its own command";
+    EXPECT_TRUE(wait_for([&]() { return mirrored[1]->latest() == 22; }, std::chrono::seconds(5)))
+        << "Replica 1 did not publish its own command";
+
+    // The same command on both draws different noise: each replica has its own seed
+    const size_t before[2] = {noise[0]->updates(), noise[1]->updates()};
+    ASSERT_TRUE(Command(prefixes[0] + ACTUATOR_SIGNAL, int8_t{5}));
+    ASSERT_TRUE(Command(prefixes[1] + ACTUATOR_SIGNAL, int8_t{5}));
+    ASSERT_TRUE(wait_for([&]() { return noise[0]->updates() > before[0] && noise[1]->updates() > before[1]; },
+                         std::chrono::seconds(5)))
+        << "Replicas did not publish their noisy outputs";
+    EXPECT_NE(noise[0]->latest(), noise[1]->latest()) << "Replicas drew the same noise";
+}
+
+/**
+ * @brief Test: An actuator without commands for max_age_ms turns its outputs NOT_AVAILABLE
+ */
+TEST_F(FixtureRunnerIntegrationTest, FixtureStaleInput) {
+    constexpr const char* ACTUATOR_SIGNAL = "Vehicle.Private.Test.Int8Actuator";
+    constexpr const char* MIRROR_SIGNAL = "Vehicle.Private.Test.Int32Actuator";
+
+    YAML::Node served = Served(ACTUATOR_SIGNAL);
+    served["max_age_ms"] = 300;
+    CreateFixturesConfig(MakeFixture("Staleness Fixture", {served},
+                                     {NativeMapping(MIRROR_SIGNAL, ACTUATOR_SIGNAL, "int32", "copy")}));
+
+    auto mirror = Observe<int32_t>(MIRROR_SIGNAL);
+    StartObserver();
+    StartFixtureRunner();
+
+    ASSERT_TRUE(Command(ACTUATOR_SIGNAL, int8_t{5}));
+    ASSERT_TRUE(wait_for([&]() { return mirror->latest() == 5; }, std::chrono::seconds(5)))
+        << "Command was not applied";
+
+    // NOT_AVAILABLE arrives as an update without a value
+    const size_t applied = mirror->updates();
+    ASSERT_TRUE(wait_for([&]() { return mirror->updates() > applied && !mirror->latest(); }, std::chrono::seconds(5)))
+        << "Output did not become NOT_AVAILABLE after max_age_ms without commands";
+
+    ASSERT_TRUE(Command(ACTUATOR_SIGNAL, int8_t{6}));
+    ASSERT_TRUE(wait_for([&]() { return mirror->latest() == 6; }, std::chrono::seconds(5)))
+        << "Output did not recover after a new command";
+}
+
+/**
+ * @brief Test: Unconnected actuators of one fixture are evaluated as separate parts
+ */
+TEST_F(FixtureRunnerIntegrationTest, FixtureIndependentParts) {
+    constexpr const char* FIRST_ACTUATOR = "Vehicle.Private.Test.Int8Actuator";
+    constexpr const char* SECOND_ACTUATOR = "Vehicle.Private.Test.Int32Actuator";
+
+    YAML::Node config = MakeFixture(
+        "Partitioned Fixture", {Served(FIRST_ACTUATOR), Served(SECOND_ACTUATOR)},
+        {NativeMapping(FIRST_ACTUATOR, FIRST_ACTUATOR, "int8", "copy"),
+         LuaMapping(SECOND_ACTUATOR, SECOND_ACTUATOR, "int32", Dep(SECOND_ACTUATOR) + " * 2")});
+    config["fixture"]["partitions"] = 2;
+    CreateFixturesConfig(config);
+
+    auto first_value = Observe<int8_t>(FIRST_ACTUATOR);
+    auto second_value = Observe<int32_t>(SECOND_ACTUATOR);
+    StartObserver();
+    StartFixtureRunner();
+
+    ASSERT_TRUE(Command(FIRST_ACTUATOR, int8_t{9}));
+    ASSERT_TRUE(Command(SECOND_ACTUATOR, int32_t{21}));
+
+    EXPECT_TRUE(wait_for([&]() { return first_value->latest() == 9; }, std::chrono::seconds(5)))
+        << "First part did not publish";
+    EXPECT_TRUE(wait_for([&]() { return second_value->latest() == 42; }, std::chrono::seconds(5)))
+        << "Second part did not publish";
+}
+
+/**
+ * @brief Test: A path two fixtures publish follows the one with higher precedence
+ */
+TEST_F(FixtureRunnerIntegrationTest, FixtureMergedOutput) {
+    constexpr const char* HIGH_ACTUATOR = "Vehicle.Private.Test.Int8Actuator";
+    constexpr const char* LOW_ACTUATOR = "Vehicle.Private.Test.Int32Actuator";
+    const std::string second_config_path = "/tmp/test_fixtures_2.yaml";
+
+    // Both write the HVAC path, scaled so the writer can be told apart
+    auto make_fixture = [&](const char* name, const char* actuator, int precedence) {
+        YAML::Node config = MakeFixture(
+            name, {Served(actuator)},
+            {LuaMapping(TEST_HVAC_ACTUATOR, actuator, "int32", Dep(actuator) + " * " + std::to_string(precedence + 1))});
+        config["fixture"]["broker"] = getKuksaAddress();
+        config["fixture"]["precedence"] = precedence;
+        return config;
+    };
+    CreateFixturesConfig(make_fixture("High Fixture", HIGH_ACTUATOR, 9));
+    CreateFixturesConfig(make_fixture("Low Fixture", LOW_ACTUATOR, 0), second_config_path);
+
+    auto hvac = Observe<int32_t>(TEST_HVAC_ACTUATOR);
+    StartObserver();
+    StartFixtureRunner({"--config", second_config_path, "--merge-hold-ms", "5000"});
+
+    ASSERT_TRUE(Command(LOW_ACTUATOR, int32_t{5}));
+    EXPECT_TRUE(wait_for([&]() { return hvac->latest() == 5; }, std::chrono::seconds(5)))
+        << "Low fixture did not publish while alone";
+
+    ASSERT_TRUE(Command(HIGH_ACTUATOR, int8_t{3}));
+    EXPECT_TRUE(wait_for([&]() { return hvac->latest() == 30; }, std::chrono::seconds(5)))
+        << "High fixture did not take over";
+
+    // The low fixture is held off while the high one is active
+    ASSERT_TRUE(Command(LOW_ACTUATOR, int32_t{7}));
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    EXPECT_EQ(hvac->latest(), 30);
+
+    unlink(second_config_path.c_str());
+}
+
+/**
+ * @brief Test: Initial values are published, and evaluated, before any command
+ */
+TEST_F(FixtureRunnerIntegrationTest, FixtureInitialValues) {
+    constexpr const char* ACTUATOR_SIGNAL = "Vehicle.Private.Test.Int8Actuator";
+    constexpr const char* DERIVED_SIGNAL = "Vehicle.Private.Test.Int32Actuator";
+
+    // The delayed mapping would not produce anything for a minute
+    YAML::Node actuator = NativeMapping(ACTUATOR_SIGNAL, ACTUATOR_SIGNAL, "int8", "delayed");
+    actuator["initial"] = 12;
+    actuator["transform"]["delay_ms"] = 60000;
+    CreateFixturesConfig(MakeFixture(
+        "Initial Value Fixture", {Served(ACTUATOR_SIGNAL)},
+        {actuator, LuaMapping(DERIVED_SIGNAL, ACTUATOR_SIGNAL, "int32", Dep(ACTUATOR_SIGNAL) + " * 2")}));
+
+    auto actuator_value = Observe<int8_t>(ACTUATOR_SIGNAL);
+    auto derived_value = Observe<int32_t>(DERIVED_SIGNAL);
+    StartObserver();
+    StartFixtureRunner();
+
+    EXPECT_TRUE(wait_for([&]() { return actuator_value->latest() == 12; }, std::chrono::seconds(5)))
+        << "Initial value not published";
+    EXPECT_TRUE(wait_for([&]() { return derived_value->latest() == 24; }, std::chrono::seconds(5)))
+        << "Initial value not evaluated";
+}
+
+/**
+ * @brief Test: Startup failures exit with the code of their type and are reported
+ */
+TEST_F(FixtureRunnerIntegrationTest, FixtureStartupErrors) {
+    const std::string report_path = "/tmp/test_startup_report.json";
+
+    YAML::Node config;
+    YAML::Node fixture;
+    fixture["name"] = "Unknown Signal Fixture";
+    fixture["serves"].push_back("Vehicle.Private.Test.NoSuchActuator");
+    YAML::Node mapping;
+    mapping["signal"] = "Vehicle.Private.Test.NoSuchActuator";
+    mapping["depends_on"].push_back("Vehicle.Private.Test.NoSuchActuator");
+    mapping["datatype"] = "int32";
+    mapping["transform"]["native"] = "copy";
+    fixture["mappings"].push_back(mapping);
+    config["fixture"] = fixture;
+    CreateFixturesConfig(config);
+
+    EXPECT_EQ(RunFixtureRunnerToExit({"--startup-report", report_path}), EX_DATAERR);
+    YAML::Node report = YAML::LoadFile(report_path);
+    EXPECT_FALSE(report["ok"].as<bool>());
+    EXPECT_EQ(report["error"]["type"].as<std::string>(), "resolution");
+    EXPECT_FALSE(report["error"]["transient"].as<bool>());
+    EXPECT_EQ(report["error"]["fixture"].as<std::string>(), "Unknown Signal Fixture");
+
+    // No serves section
+    config["fixture"].remove("serves");
+    CreateFixturesConfig(config);
+    EXPECT_EQ(RunFixtureRunnerToExit({"--startup-report", report_path}), EX_CONFIG);
+    report = YAML::LoadFile(report_path);
+    EXPECT_EQ(report["error"]["type"].as<std::string>(), "config");
+
+    // Initial value of a served actuator that its accept rules refuse
+    YAML::Node refused;
+    refused["name"] = "Refused Initial Fixture";
+    YAML::Node served;
+    served["signal"] = "Vehicle.Private.Test.Int8Actuator";
+    served["accept"]["min"] = 0;
+    served["accept"]["max"] = 100;
+    refused["serves"].push_back(served);
+    YAML::Node initial;
+    initial["signal"] = "Vehicle.Private.Test.Int8Actuator";
+    initial["datatype"] = "int8";
+    initial["initial"] = -5;
+    refused["mappings"].push_back(initial);
+    config["fixture"] = refused;
+    CreateFixturesConfig(config);
+    EXPECT_EQ(RunFixtureRunnerToExit({"--startup-report", report_path}), EX_CONFIG);
+    report = YAML::LoadFile(report_path);
+    EXPECT_EQ(report["error"]["type"].as<std::string>(), "config");
+
+    // Broker on a port nobody listens on: transient, worth retrying
+    YAML::Node unreachable;
+    unreachable["name"] = "Unreachable Broker Fixture";
+    unreachable["broker"] = "127.0.0.1:1";
+    unreachable["serves"].push_back("Vehicle.Private.Test.Int8Actuator");
+    config["fixture"] = unreachable;
+    CreateFixturesConfig(config);
+    EXPECT_EQ(RunFixtureRunnerToExit({"--startup-report", report_path}), EX_UNAVAILABLE);
+    report = YAML::LoadFile(report_path);
+    EXPECT_EQ(report["error"]["type"].as<std::string>(), "broker_unreachable");
+    EXPECT_TRUE(report["error"]["transient"].as<bool>());
+
+    unlink(report_path.c_str());
+}
+
 int main(int argc, char** argv) {
     google::InitGoogleLogging(argv[0]);
     FLAGS_logtostderr = 1;
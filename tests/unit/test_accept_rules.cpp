@@ -0,0 +1,79 @@
+/**
+ * @file test_accept_rules.cpp
+ * @brief Unit tests for AcceptRules parsing and checks
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <limits>
+#include <string>
+#include <yaml-cpp/yaml.h>
+#include "accept_rules.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+AcceptRules Parsed(const std::string& yaml) {
+    AcceptRules rules;
+    const auto error = AcceptRules::Parse(YAML::Load(yaml), rules);
+    EXPECT_FALSE(error) << *error;
+    return rules;
+}
+
+const std::chrono::steady_clock::time_point kStart{};
+
+}  // namespace
+
+TEST(AcceptRulesTest, ChecksRange) {
+    AcceptRules rules = Parsed("{min: 0, max: 100}");
+    EXPECT_EQ(rules.check(int32_t{0}, kStart), nullptr);
+    EXPECT_EQ(rules.check(100.0, kStart), nullptr);
+    EXPECT_STREQ(rules.check(int8_t{-1}, kStart), "value out of range");
+    EXPECT_STREQ(rules.check(100.5f, kStart), "value out of range");
+    EXPECT_STREQ(rules.check(std::string("50"), kStart), "value not numeric");
+    EXPECT_STREQ(rules.check(std::numeric_limits<double>::quiet_NaN(), kStart), "value not numeric");
+}
+
+TEST(AcceptRulesTest, ChecksListedValues) {
+    AcceptRules rules = Parsed("{values: [OFF, LOW, 3, true]}");
+    EXPECT_EQ(rules.check(std::string("OFF"), kStart), nullptr);
+    EXPECT_EQ(rules.check(std::string("LOW"), kStart), nullptr);
+    EXPECT_EQ(rules.check(int32_t{3}, kStart), nullptr);
+    EXPECT_EQ(rules.check(3.0, kStart), nullptr);
+    EXPECT_EQ(rules.check(true, kStart), nullptr);
+    EXPECT_STREQ(rules.check(std::string("AUTO"), kStart), "value not allowed");
+    EXPECT_STREQ(rules.check(std::string("off"), kStart), "value not allowed");
+    EXPECT_STREQ(rules.check(false, kStart), "value not allowed");
+    EXPECT_STREQ(rules.check(int32_t{4}, kStart), "value not allowed");
+}
+
+TEST(AcceptRulesTest, LimitsRateOfAcceptedCommands) {
+    AcceptRules rules = Parsed("{max_rate: 10}");
+    EXPECT_EQ(rules.check(0.0, kStart), nullptr);  // Nothing to compare with yet
+    EXPECT_EQ(rules.check(5.0, kStart + 500ms), nullptr);
+    EXPECT_STREQ(rules.check(20.0, kStart + 1s), "value changes too fast");
+
+    // A rejected command does not move the reference
+    EXPECT_EQ(rules.check(10.0, kStart + 1s), nullptr);
+    EXPECT_EQ(rules.check(0.0, kStart + 2s), nullptr);
+}
+
+TEST(AcceptRulesTest, PrimedValueLimitsFirstCommand) {
+    AcceptRules rules = Parsed("{max_rate: 10}");
+    rules.prime(int32_t{50}, kStart);
+    EXPECT_STREQ(rules.check(0.0, kStart + 1s), "value changes too fast");
+    EXPECT_EQ(rules.check(45.0, kStart + 1s), nullptr);
+}
+
+TEST(AcceptRulesTest, RejectsInvalidRules) {
+    AcceptRules rules;
+    EXPECT_TRUE(AcceptRules::Parse(YAML::Load("[1, 2]"), rules));
+    EXPECT_TRUE(AcceptRules::Parse(YAML::Load("{min: 5, max: 1}"), rules));
+    EXPECT_TRUE(AcceptRules::Parse(YAML::Load("{max_rate: -1}"), rules));
+    EXPECT_TRUE(AcceptRules::Parse(YAML::Load("{values: []}"), rules));
+    EXPECT_TRUE(AcceptRules::Parse(YAML::Load("{step: 1}"), rules));
+    EXPECT_TRUE(AcceptRules::Parse(YAML::Load("{min: low}"), rules));
+    EXPECT_TRUE(AcceptRules().empty());
+}
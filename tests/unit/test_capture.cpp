@@ -0,0 +1,215 @@
+/**
+ * @file test_capture.cpp
+ * @brief Unit tests for CaptureReader on intact, truncated and damaged files
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "capture.hpp"
+#include "gorilla.hpp"
+
+namespace {
+
+// Builds capture file contents record by record
+class CaptureBytes {
+public:
+    explicit CaptureBytes(uint32_t version = capture::kVersion) {
+        out_.append(capture::kMagic, sizeof(capture::kMagic));
+        Put(version);
+    }
+
+    CaptureBytes& Signal(uint32_t id, const std::string& name) {
+        Put(capture::kSignalRecord);
+        Put(id);
+        Put(static_cast<uint16_t>(name.size()));
+        out_ += name;
+        return *this;
+    }
+
+    CaptureBytes& Seed(const std::string& fixture, uint64_t seed) {
+        Put(capture::kSeedRecord);
+        Put(uint32_t{0});
+        Put(static_cast<uint16_t>(fixture.size()));
+        out_ += fixture;
+        Put(seed);
+        return *this;
+    }
+
+    // A chunk of |count| points, one per millisecond from |first_us|
+    CaptureBytes& Chunk(uint32_t id, int64_t first_us, uint32_t count) {
+        GorillaEncoder encoder;
+        for (uint32_t i = 0; i < count; ++i) {
+            encoder.append(first_us + i * 1000, i * 0.5);
+        }
+        return RawChunk(id, count, first_us, static_cast<uint32_t>(encoder.bytes().size()),
+                        std::string(encoder.bytes().begin(), encoder.bytes().end()));
+    }
+
+    CaptureBytes& RawChunk(uint32_t id, uint32_t count, int64_t first_us, uint32_t size,
+                           const std::string& data) {
+        Put(capture::kChunkRecord);
+        Put(id);
+        Put(count);
+        Put(first_us);
+        Put(size);
+        out_ += data;
+        return *this;
+    }
+
+    const std::string& str() const { return out_; }
+
+private:
+    template <typename T>
+    void Put(T value) {
+        out_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    std::string out_;
+};
+
+class CaptureReaderTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        for (const auto& path : paths_) {
+            unlink(path.c_str());
+        }
+    }
+
+    std::string Write(const std::string& content) {
+        const std::string path = "/tmp/test_capture_" + std::to_string(getpid()) + "_" +
+                                 std::to_string(paths_.size()) + ".fxcp";
+        std::ofstream(path, std::ios::binary) << content;
+        paths_.push_back(path);
+        return path;
+    }
+
+    // Signal names of the chunks |reader| yields, in order
+    static std::vector<std::string> Signals(CaptureReader& reader) {
+        std::vector<std::string> signals;
+        CaptureReader::Chunk chunk;
+        while (reader.next(chunk)) {
+            signals.push_back(*chunk.signal);
+        }
+        return signals;
+    }
+
+    std::vector<std::string> paths_;
+};
+
+CaptureBytes TwoSignals() {
+    CaptureBytes bytes;
+    bytes.Seed("Doors", 7)
+        .Signal(1, "Vehicle.Speed")
+        .Chunk(1, 2000000, 10)
+        .Signal(2, "Vehicle.Cabin.Door.Row1.Left.IsLocked")
+        .Chunk(2, 1000000, 3)
+        .Chunk(1, 2010000, 5);
+    return bytes;
+}
+
+TEST_F(CaptureReaderTest, ReadsChunksInFileOrder) {
+    CaptureReader reader(Write(TwoSignals().str()));
+    ASSERT_EQ(reader.error(), "");
+    EXPECT_EQ(reader.start_timestamp(), 1000000);
+
+    CaptureReader::Chunk chunk;
+    ASSERT_TRUE(reader.next(chunk));
+    EXPECT_EQ(*chunk.signal, "Vehicle.Speed");
+    EXPECT_EQ(chunk.count, 10u);
+    EXPECT_EQ(chunk.first_timestamp_us, 2000000);
+    EXPECT_EQ(reader.seeds().at("Doors"), 7u);
+
+    GorillaDecoder decoder(chunk.bytes.data(), chunk.bytes.size(), chunk.count);
+    int64_t timestamp;
+    double value;
+    for (uint32_t i = 0; i < chunk.count; ++i) {
+        ASSERT_TRUE(decoder.next(timestamp, value));
+        EXPECT_EQ(timestamp, 2000000 + i * 1000);
+        EXPECT_EQ(value, i * 0.5);
+    }
+
+    EXPECT_EQ(Signals(reader),
+              (std::vector<std::string>{"Vehicle.Cabin.Door.Row1.Left.IsLocked", "Vehicle.Speed"}));
+    EXPECT_EQ(reader.error(), "");
+}
+
+TEST_F(CaptureReaderTest, TruncatedTailEndsTheFile) {
+    // A writer killed mid-record leaves a prefix of it; every cut point keeps
+    // the complete chunks before it and is not an error
+    const std::string full = TwoSignals().str();
+    CaptureBytes head;
+    head.Seed("Doors", 7)
+        .Signal(1, "Vehicle.Speed")
+        .Chunk(1, 2000000, 10)
+        .Signal(2, "Vehicle.Cabin.Door.Row1.Left.IsLocked")
+        .Chunk(2, 1000000, 3);
+    const size_t intact = head.str().size();
+    ASSERT_LT(intact, full.size());
+
+    for (size_t cut = intact + 1; cut < full.size(); ++cut) {
+        CaptureReader reader(Write(full.substr(0, cut)));
+        ASSERT_EQ(reader.error(), "");
+        EXPECT_EQ(Signals(reader).size(), 2u) << "cut at " << cut;
+        EXPECT_EQ(reader.error(), "") << "cut at " << cut;
+    }
+}
+
+TEST_F(CaptureReaderTest, TruncatedHeaderIsNotACapture) {
+    const std::string full = CaptureBytes().str();
+    for (size_t cut = 0; cut < full.size(); ++cut) {
+        CaptureReader reader(Write(full.substr(0, cut)));
+        EXPECT_NE(reader.error().find("is not a capture file"), std::string::npos) << reader.error();
+        CaptureReader::Chunk chunk;
+        EXPECT_FALSE(reader.next(chunk));
+    }
+}
+
+TEST_F(CaptureReaderTest, DamagedLengthIsAnError) {
+    CaptureBytes bytes;
+    bytes.Signal(1, "Vehicle.Speed").Chunk(1, 0, 4).RawChunk(1, 4, 1000, 0xFFFFFFF0u, "garbage");
+    CaptureReader reader(Write(bytes.str()));
+    ASSERT_EQ(reader.error(), "");
+
+    CaptureReader::Chunk chunk;
+    EXPECT_TRUE(reader.next(chunk));
+    EXPECT_FALSE(reader.next(chunk));
+    EXPECT_NE(reader.error().find("damaged chunk record"), std::string::npos) << reader.error();
+    EXPECT_FALSE(reader.next(chunk));
+}
+
+TEST_F(CaptureReaderTest, DamagedRecordsAreErrors) {
+    {
+        CaptureBytes bytes;
+        bytes.Signal(1, "Vehicle.Speed").Chunk(2, 0, 4);
+        CaptureReader reader(Write(bytes.str()));
+        EXPECT_TRUE(Signals(reader).empty());
+        EXPECT_NE(reader.error().find("undeclared signal 2"), std::string::npos) << reader.error();
+    }
+    {
+        std::string bytes = CaptureBytes().Signal(1, "Vehicle.Speed").str();
+        bytes += '\x09';
+        bytes.append(16, '\0');
+        CaptureReader reader(Write(bytes));
+        EXPECT_TRUE(Signals(reader).empty());
+        EXPECT_NE(reader.error().find("unknown record type 9"), std::string::npos) << reader.error();
+    }
+}
+
+TEST_F(CaptureReaderTest, VersionsOutsideTheKnownRangeAreRejected) {
+    CaptureReader v1(Write(CaptureBytes(1).Signal(1, "Vehicle.Speed").Chunk(1, 0, 2).str()));
+    EXPECT_EQ(v1.error(), "");
+    EXPECT_EQ(Signals(v1).size(), 1u);
+
+    for (uint32_t version : {0u, capture::kVersion + 1}) {
+        CaptureReader reader(Write(CaptureBytes(version).str()));
+        EXPECT_NE(reader.error().find("unsupported capture version"), std::string::npos)
+            << reader.error();
+    }
+}
+
+}  // namespace
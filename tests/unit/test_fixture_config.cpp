@@ -0,0 +1,58 @@
+/**
+ * @file test_fixture_config.cpp
+ * @brief Unit tests for fixture file checks that need no broker
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include "fixture_config.hpp"
+
+namespace {
+
+// Fixture serving an int8 actuator accepted in [0, 100] with |initial|
+std::string InitialValueFixture(int initial) {
+    return "fixture:\n"
+           "  name: Initial\n"
+           "  serves:\n"
+           "    - signal: Vehicle.Private.Test.Int8Actuator\n"
+           "      accept: {min: 0, max: 100}\n"
+           "  mappings:\n"
+           "    - signal: Vehicle.Private.Test.Int8Actuator\n"
+           "      depends_on: [Vehicle.Private.Test.Int8Actuator]\n"
+           "      datatype: int8\n"
+           "      initial: " + std::to_string(initial) + "\n"
+           "      transform: {native: copy}\n";
+}
+
+class FixtureConfigTest : public ::testing::Test {
+protected:
+    void TearDown() override { unlink(path_.c_str()); }
+
+    bool Load(const std::string& yaml, FixtureConfig& config, std::string& message) {
+        std::ofstream(path_) << yaml;
+        return LoadFixtureConfig(path_, config, &message);
+    }
+
+    const std::string path_ = "/tmp/test_fixture_config_" + std::to_string(getpid()) + ".yaml";
+};
+
+}  // namespace
+
+TEST_F(FixtureConfigTest, AcceptsInitialValuePassingAcceptRules) {
+    FixtureConfig config;
+    std::string message;
+    ASSERT_TRUE(Load(InitialValueFixture(5), config, message)) << message;
+    ASSERT_EQ(config.initial.count("Vehicle.Private.Test.Int8Actuator"), 1u);
+}
+
+TEST_F(FixtureConfigTest, RejectsInitialValueFailingAcceptRules) {
+    FixtureConfig config;
+    std::string message;
+    EXPECT_FALSE(Load(InitialValueFixture(-5), config, message));
+    EXPECT_NE(message.find("Initial value for Vehicle.Private.Test.Int8Actuator fails its accept rules"),
+              std::string::npos) << message;
+}
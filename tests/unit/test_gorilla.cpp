@@ -0,0 +1,131 @@
+/**
+ * @file test_gorilla.cpp
+ * @brief Unit tests for the Gorilla encoder/decoder round trip
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "gorilla.hpp"
+
+namespace {
+
+using Points = std::vector<std::pair<int64_t, double>>;
+
+uint64_t Bits(double v) {
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+// Encode |points| and decode them again; values compare bit for bit, so
+// NaN payloads and the sign of zero must survive too
+void ExpectRoundTrip(const Points& points) {
+    GorillaEncoder encoder;
+    for (const auto& [timestamp, value] : points) {
+        encoder.append(timestamp, value);
+    }
+    ASSERT_EQ(encoder.count(), points.size());
+    if (!points.empty()) {
+        EXPECT_EQ(encoder.first_timestamp(), points.front().first);
+    }
+
+    GorillaDecoder decoder(encoder.bytes().data(), encoder.bytes().size(), encoder.count());
+    int64_t timestamp;
+    double value;
+    for (size_t i = 0; i < points.size(); ++i) {
+        ASSERT_TRUE(decoder.next(timestamp, value)) << "point " << i;
+        EXPECT_EQ(timestamp, points[i].first) << "point " << i;
+        EXPECT_EQ(Bits(value), Bits(points[i].second)) << "point " << i << ": " << value;
+    }
+    EXPECT_FALSE(decoder.next(timestamp, value));
+}
+
+TEST(GorillaTest, RegularSignalRoundTrips) {
+    Points points;
+    for (int i = 0; i < 1000; ++i) {
+        points.emplace_back(1700000000000000LL + i * 10000LL, 20.0 + (i % 7) * 0.25);
+    }
+    ExpectRoundTrip(points);
+}
+
+TEST(GorillaTest, SpecialValuesRoundTrip) {
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    ExpectRoundTrip({{0, nan},
+                     {1000, 1.0},
+                     {2000, inf},
+                     {3000, -inf},
+                     {4000, nan},
+                     {5000, -nan},
+                     {6000, 0.0},
+                     {7000, -0.0},
+                     {8000, std::numeric_limits<double>::denorm_min()},
+                     {9000, std::numeric_limits<double>::max()},
+                     {10000, std::numeric_limits<double>::lowest()},
+                     {11000, inf}});
+}
+
+TEST(GorillaTest, NearlyEqualValuesRoundTrip) {
+    // XORs with more leading zeros than the 5-bit field holds
+    const double one = 1.0;
+    const double next = std::nextafter(one, 2.0);
+    ExpectRoundTrip({{0, one}, {1, next}, {2, one}, {3, std::nextafter(next, 2.0)}, {4, 1.5}, {5, one}});
+}
+
+TEST(GorillaTest, EqualTimestampsRoundTrip) {
+    // Several publishes within one microsecond, then a repeat of the pattern
+    ExpectRoundTrip({{5000, 1.0}, {5000, 2.0}, {5000, 3.0}, {6000, 3.0}, {6000, 4.0}, {6000, 4.0}});
+}
+
+TEST(GorillaTest, DeltasOfEveryWidthRoundTrip) {
+    // Delta-of-delta values at the edges of each bucket, and beyond 32 bits
+    Points points{{0, 0.0}};
+    int64_t timestamp = 0;
+    int64_t delta = 0;
+    const int64_t dods[] = {0,    -63,  64,         -255,        256,         -2047,        2048,
+                            2049, -2048, 2147483647, 2147483648LL, -2147483647, -2147483648LL,
+                            1LL << 40,    -(1LL << 41), 1LL << 40};
+    for (int64_t dod : dods) {
+        delta += dod;
+        timestamp += delta;
+        points.emplace_back(timestamp, static_cast<double>(points.size()));
+    }
+    ExpectRoundTrip(points);
+}
+
+TEST(GorillaTest, ExtremeTimestampsRoundTrip) {
+    const int64_t min = std::numeric_limits<int64_t>::min() / 2;
+    const int64_t max = std::numeric_limits<int64_t>::max() / 2;
+    ExpectRoundTrip({{min, 1.0}, {0, 2.0}, {max, 3.0}, {max, 3.0}, {-1, 4.0}});
+}
+
+TEST(GorillaTest, EmptyAndSinglePoint) {
+    ExpectRoundTrip({});
+    ExpectRoundTrip({{-42, 3.5}});
+}
+
+TEST(GorillaTest, TruncatedStreamStopsDecoding) {
+    GorillaEncoder encoder;
+    for (int i = 0; i < 100; ++i) {
+        encoder.append(i * 1000 + (i * i) % 17, i * 1.5);
+    }
+    const auto& bytes = encoder.bytes();
+    GorillaDecoder decoder(bytes.data(), bytes.size() / 2, encoder.count());
+    int64_t timestamp;
+    double value;
+    size_t decoded = 0;
+    while (decoder.next(timestamp, value)) {
+        EXPECT_EQ(value, decoded * 1.5);
+        ++decoded;
+    }
+    EXPECT_GT(decoded, 0u);
+    EXPECT_LT(decoded, encoder.count());
+}
+
+}  // namespace
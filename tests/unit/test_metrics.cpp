@@ -0,0 +1,54 @@
+/**
+ * @file test_metrics.cpp
+ * @brief Unit tests for sharded counters and histograms
+ */
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+#include "metrics.hpp"
+
+namespace {
+
+TEST(MetricsTest, ShardCountIsAPowerOfTwo) {
+    EXPECT_GE(DefaultMetricShards(), 16u);
+    EXPECT_GE(DefaultMetricShards(), 2 * size_t{std::thread::hardware_concurrency()});
+    EXPECT_EQ(DefaultMetricShards() & (DefaultMetricShards() - 1), 0u);
+
+    EXPECT_EQ(MetricsRegistry(1).shards(), 1u);
+    EXPECT_EQ(MetricsRegistry(5).shards(), 8u);
+    EXPECT_EQ(MetricsRegistry(64).shards(), 64u);
+    EXPECT_EQ(MetricsRegistry().shards(), DefaultMetricShards());
+}
+
+TEST(MetricsTest, MoreThreadsThanShardsLoseNoEvents) {
+    MetricsRegistry registry(4);
+    Counter& counter = registry.counter("test.events_total");
+    Histogram& histogram = registry.histogram("test.event_us");
+    EXPECT_EQ(&counter, &registry.counter("test.events_total"));
+
+    constexpr int kThreads = 13;
+    constexpr int kEvents = 10000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < kEvents; ++i) {
+                counter.inc();
+                histogram.observe(t == 0 && i == 0 ? 5000 : 3);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(counter.value(), uint64_t{kThreads} * kEvents);
+    const auto json = histogram.to_json();
+    EXPECT_EQ(json["count"].get<uint64_t>(), uint64_t{kThreads} * kEvents);
+    EXPECT_EQ(json["sum"].get<uint64_t>(), uint64_t{kThreads} * kEvents * 3 + 4997);
+    EXPECT_EQ(json["max"].get<uint64_t>(), 5000u);
+    EXPECT_EQ(registry.to_json()["counters"]["test.events_total"].get<uint64_t>(), uint64_t{kThreads} * kEvents);
+}
+
+}  // namespace
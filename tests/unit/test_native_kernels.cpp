@@ -0,0 +1,182 @@
+/**
+ * @file test_native_kernels.cpp
+ * @brief Unit tests for the native mapping kernels against scalar references
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "native_kernels.hpp"
+
+using namespace fixture_native;
+
+namespace {
+
+constexpr size_t kLanes = 37;  // Not a multiple of any vector width
+
+bool SameBits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+}  // namespace
+
+TEST(NativeKernelsTest, LowpassBankMatchesScalarSteps) {
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<double> value(-100.0, 100.0);
+    std::vector<double> x(kLanes), alpha(kLanes), y(kLanes, 0.0), expected(kLanes, 0.0);
+    std::vector<uint8_t> active(kLanes), primed(kLanes, 0), expected_primed(kLanes, 0);
+    for (size_t i = 0; i < kLanes; ++i) {
+        alpha[i] = (i + 1) / static_cast<double>(kLanes + 1);
+    }
+
+    for (int round = 0; round < 50; ++round) {
+        for (size_t i = 0; i < kLanes; ++i) {
+            x[i] = value(rng);
+            active[i] = rng() % 3 != 0;
+            if (active[i]) {
+                expected[i] = lowpass_step(expected[i], x[i], alpha[i], expected_primed[i] != 0);
+                expected_primed[i] = 1;
+            }
+        }
+        lowpass_bank(kLanes, x.data(), alpha.data(), active.data(), primed.data(), y.data());
+        for (size_t i = 0; i < kLanes; ++i) {
+            ASSERT_TRUE(SameBits(y[i], expected[i])) << "lane " << i << " round " << round;
+            ASSERT_EQ(primed[i], expected_primed[i]);
+        }
+    }
+}
+
+TEST(NativeKernelsTest, DerivativeBankMatchesScalarSteps) {
+    std::mt19937_64 rng(2);
+    std::uniform_real_distribution<double> value(-100.0, 100.0);
+    std::vector<double> x(kLanes), prev_x(kLanes, 0.0), prev_t(kLanes, 0.0), y(kLanes, 0.0);
+    std::vector<double> ref_prev_x(kLanes, 0.0), ref_prev_t(kLanes, 0.0), expected(kLanes, 0.0);
+    std::vector<uint8_t> active(kLanes), primed(kLanes, 0), ref_primed(kLanes, 0);
+
+    double now_s = 10.0;
+    for (int round = 0; round < 50; ++round) {
+        now_s += 0.01 * (1 + rng() % 10);
+        for (size_t i = 0; i < kLanes; ++i) {
+            x[i] = value(rng);
+            active[i] = rng() % 2;
+            if (active[i]) {
+                expected[i] = derivative_step(x[i], ref_prev_x[i], now_s - ref_prev_t[i], ref_primed[i] != 0);
+                ref_prev_x[i] = x[i];
+                ref_prev_t[i] = now_s;
+                ref_primed[i] = 1;
+            }
+        }
+        derivative_bank(kLanes, x.data(), active.data(), now_s, prev_x.data(), prev_t.data(), primed.data(),
+                        y.data());
+        for (size_t i = 0; i < kLanes; ++i) {
+            ASSERT_TRUE(SameBits(y[i], expected[i])) << "lane " << i << " round " << round;
+        }
+    }
+}
+
+TEST(NativeKernelsTest, DerivativeNeedsPrimingAndTime) {
+    EXPECT_EQ(derivative_step(5.0, 1.0, 0.5, false), 0.0);
+    EXPECT_EQ(derivative_step(5.0, 1.0, 0.0, true), 0.0);
+    EXPECT_DOUBLE_EQ(derivative_step(5.0, 1.0, 0.5, true), 8.0);
+}
+
+TEST(NativeKernelsTest, NoiseBankMatchesScalarSteps) {
+    std::vector<double> x(kLanes, 1.0), stddev(kLanes, 2.0), y(kLanes, 0.0);
+    std::vector<uint64_t> key(kLanes), counter(kLanes, 0);
+    std::vector<uint8_t> active(kLanes);
+    for (size_t i = 0; i < kLanes; ++i) {
+        key[i] = mix64(i);
+        active[i] = i % 2;
+    }
+    noise_bank(kLanes, x.data(), stddev.data(), key.data(), active.data(), counter.data(), y.data());
+    for (size_t i = 0; i < kLanes; ++i) {
+        EXPECT_EQ(counter[i], active[i] ? 1u : 0u);
+        EXPECT_TRUE(SameBits(y[i], active[i] ? noise_step(1.0, 2.0, key[i], 0) : 0.0)) << "lane " << i;
+    }
+}
+
+TEST(NativeKernelsTest, MovingAverageMatchesWindowMean) {
+    for (uint32_t window : {1u, 2u, 7u, 64u}) {
+        std::vector<double> ring(window, 0.0);
+        uint32_t head = 0;
+        uint32_t count = 0;
+        double sum = 0.0;
+        std::deque<double> last;
+
+        std::mt19937_64 rng(window);
+        std::uniform_real_distribution<double> value(-1e3, 1e3);
+        for (int i = 0; i < 1000; ++i) {
+            const double x = value(rng);
+            last.push_back(x);
+            if (last.size() > window) {
+                last.pop_front();
+            }
+            const double mean = std::accumulate(last.begin(), last.end(), 0.0) / last.size();
+            const double y = moving_average_step(ring.data(), window, head, count, sum, x);
+            ASSERT_NEAR(y, mean, 1e-9) << "window " << window << " sample " << i;
+            ASSERT_EQ(count, std::min<uint32_t>(i + 1, window));
+            ASSERT_LT(head, window);
+        }
+    }
+}
+
+TEST(NativeKernelsTest, MovingAverageRunningSumDoesNotDrift) {
+    // Large values entering and leaving would strand rounding error in a
+    // running sum; the recompute on wrap clears it
+    constexpr uint32_t kWindow = 16;
+    std::vector<double> ring(kWindow, 0.0);
+    uint32_t head = 0;
+    uint32_t count = 0;
+    double sum = 0.0;
+    for (int i = 0; i < 100000; ++i) {
+        moving_average_step(ring.data(), kWindow, head, count, sum, i % 2 ? 1e15 : 0.1);
+    }
+    double y = 0.0;
+    for (uint32_t i = 0; i < kWindow; ++i) {
+        y = moving_average_step(ring.data(), kWindow, head, count, sum, 0.25);
+    }
+    EXPECT_EQ(y, 0.25);
+}
+
+TEST(NativeKernelsTest, DelayedRestartsOnNewInput) {
+    const Clock::time_point start{};
+    DelayedState state;
+    double out = 0.0;
+    EXPECT_FALSE(delayed_fire(state, start, out));
+
+    delayed_arm(state, 1.0, start, std::chrono::milliseconds(100));
+    delayed_arm(state, 2.0, start + std::chrono::milliseconds(50), std::chrono::milliseconds(100));
+    EXPECT_FALSE(delayed_fire(state, start + std::chrono::milliseconds(120), out));
+    EXPECT_TRUE(delayed_fire(state, start + std::chrono::milliseconds(150), out));
+    EXPECT_EQ(out, 2.0);
+    EXPECT_FALSE(delayed_fire(state, start + std::chrono::milliseconds(300), out));
+}
+
+TEST(NativeKernelsTest, SamplingStartsWithFirstInputAndDoesNotBurst) {
+    double next = kNever;
+    EXPECT_FALSE(sample_active(false, 0.0, 0.1, next));
+    EXPECT_TRUE(sample_active(true, 1.0, 0.1, next));
+    EXPECT_DOUBLE_EQ(next, 1.1);
+    EXPECT_FALSE(sample_active(false, 1.05, 0.1, next));
+    EXPECT_TRUE(sample_active(false, 1.1, 0.1, next));
+
+    // Far behind: one sample, then the cadence restarts from now
+    EXPECT_TRUE(sample_active(false, 5.0, 0.1, next));
+    EXPECT_DOUBLE_EQ(next, 5.1);
+    EXPECT_FALSE(sample_active(false, 5.05, 0.1, next));
+}
+
+TEST(NativeKernelsTest, SustainedNeedsUnbrokenCondition) {
+    double since = -1.0;
+    EXPECT_EQ(sustained_step(true, 1.0, 0.5, since), 0.0);
+    EXPECT_EQ(sustained_step(true, 1.4, 0.5, since), 0.0);
+    EXPECT_EQ(sustained_step(true, 1.5, 0.5, since), 1.0);
+    EXPECT_EQ(sustained_step(false, 1.6, 0.5, since), 0.0);
+    EXPECT_EQ(sustained_step(true, 1.7, 0.5, since), 0.0);
+}
@@ -0,0 +1,110 @@
+/**
+ * @file test_path_trie.cpp
+ * @brief Unit tests for PathTrie lookups
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "path_trie.hpp"
+
+namespace {
+
+const std::vector<std::string> kPaths = {
+    "Vehicle.Cabin.Door.Row1.Left.IsLocked",   // 0
+    "Vehicle.Cabin.Door.Row1.Right.IsLocked",  // 1
+    "Vehicle.Cabin.Door.Row1",                 // 2: also an inner node
+    "Vehicle.Speed",                           // 3
+    "Vehicle.Cabin.Door.Row1.Left.IsLocked",   // 4: repeat of 0
+    "A.B.B",                                   // 5
+};
+
+std::vector<uint32_t> Subtree(const PathTrie& trie, const std::string& prefix) {
+    std::vector<uint32_t> values;
+    trie.subtree(prefix, values);
+    return values;
+}
+
+std::vector<uint32_t> Match(const PathTrie& trie, const std::string& pattern) {
+    std::vector<uint32_t> values;
+    trie.match(pattern, values);
+    return values;
+}
+
+}  // namespace
+
+TEST(PathTrieTest, FindsExactPaths) {
+    const PathTrie trie(kPaths);
+    EXPECT_EQ(trie.size(), 5u);
+    EXPECT_EQ(trie.find("Vehicle.Cabin.Door.Row1.Right.IsLocked"), 1u);
+    EXPECT_EQ(trie.find("Vehicle.Cabin.Door.Row1"), 2u);
+    EXPECT_EQ(trie.find("Vehicle.Speed"), 3u);
+
+    // A repeated path keeps its first value
+    EXPECT_EQ(trie.find("Vehicle.Cabin.Door.Row1.Left.IsLocked"), 0u);
+
+    // Inner nodes, partial segments and the root are not paths
+    EXPECT_FALSE(trie.contains("Vehicle.Cabin"));
+    EXPECT_FALSE(trie.contains("Vehicle.Spee"));
+    EXPECT_FALSE(trie.contains("Vehicle.Speed.Max"));
+    EXPECT_FALSE(trie.contains(""));
+    EXPECT_FALSE(PathTrie().contains("Vehicle.Speed"));
+}
+
+TEST(PathTrieTest, SubtreeIsDepthFirst) {
+    const PathTrie trie(kPaths);
+    EXPECT_EQ(Subtree(trie, "Vehicle.Cabin.Door.Row1"), (std::vector<uint32_t>{2, 0, 1}));
+    EXPECT_EQ(Subtree(trie, "Vehicle.Cabin"), (std::vector<uint32_t>{2, 0, 1}));
+    EXPECT_EQ(Subtree(trie, "Vehicle.Speed"), (std::vector<uint32_t>{3}));
+    EXPECT_EQ(Subtree(trie, ""), (std::vector<uint32_t>{5, 2, 0, 1, 3}));
+    EXPECT_TRUE(Subtree(trie, "Vehicle.Body").empty());
+    EXPECT_TRUE(Subtree(PathTrie(), "").empty());
+}
+
+TEST(PathTrieTest, MatchesWildcards) {
+    const PathTrie trie(kPaths);
+    EXPECT_EQ(Match(trie, "Vehicle.Cabin.Door.Row1.*.IsLocked"), (std::vector<uint32_t>{0, 1}));
+    EXPECT_EQ(Match(trie, "Vehicle.*"), (std::vector<uint32_t>{3}));
+    EXPECT_EQ(Match(trie, "Vehicle.**.IsLocked"), (std::vector<uint32_t>{0, 1}));
+
+    // '**' matches no segments too
+    EXPECT_EQ(Match(trie, "Vehicle.Cabin.Door.Row1.**"), (std::vector<uint32_t>{2, 0, 1}));
+    EXPECT_EQ(Match(trie, "**.Speed"), (std::vector<uint32_t>{3}));
+    EXPECT_EQ(Match(trie, "Vehicle.Speed"), (std::vector<uint32_t>{3}));
+    EXPECT_TRUE(Match(trie, "Vehicle.*.IsLocked").empty());
+    EXPECT_TRUE(Match(PathTrie(), "**").empty());
+}
+
+TEST(PathTrieTest, MatchReportsEachPathOnceInTrieOrder) {
+    const PathTrie trie(kPaths);
+
+    // A.B.B matches with either B as the literal one
+    EXPECT_EQ(Match(trie, "**.B.**"), (std::vector<uint32_t>{5}));
+    EXPECT_EQ(Match(trie, "**.**.IsLocked"), (std::vector<uint32_t>{0, 1}));
+
+    // Shorter paths first, then in segment order
+    EXPECT_EQ(Match(trie, "**"), (std::vector<uint32_t>{3, 5, 2, 0, 1}));
+}
+
+TEST(PathTrieTest, MatchVisitsEachStateOnce) {
+    // A.B, A.A.B, ... down to 400 A's: every '**' can split at any depth
+    std::vector<std::string> paths;
+    std::string prefix = "A";
+    for (int depth = 1; depth <= 400; ++depth) {
+        paths.push_back(prefix + ".B");
+        prefix += ".A";
+    }
+    const PathTrie trie(paths);
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto values = Match(trie, "**.A.**.A.**.A.**.B");
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Every path with at least three A's, each once, shortest first
+    ASSERT_EQ(values.size(), 398u);
+    EXPECT_EQ(values.front(), 2u);
+    EXPECT_EQ(values.back(), 399u);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(500)) << "Wildcard match revisits states";
+}
@@ -0,0 +1,157 @@
+/**
+ * @file test_time_series.cpp
+ * @brief Unit tests for TimeSeriesFile parsing and TimeSeriesCursor sampling
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "time_series.hpp"
+
+namespace {
+
+class TimeSeriesTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        for (const auto& path : paths_) {
+            unlink(path.c_str());
+        }
+    }
+
+    std::string Write(const std::string& content) {
+        const std::string path = "/tmp/test_time_series_" + std::to_string(getpid()) + "_" +
+                                 std::to_string(paths_.size()) + ".dat";
+        std::ofstream(path, std::ios::binary) << content;
+        paths_.push_back(path);
+        return path;
+    }
+
+    std::shared_ptr<const TimeSeriesFile> Open(const std::string& content) {
+        std::string error;
+        auto file = TimeSeriesFile::Open(Write(content), error);
+        EXPECT_TRUE(file) << error;
+        return file;
+    }
+
+    std::string OpenError(const std::string& content) {
+        std::string error;
+        EXPECT_FALSE(TimeSeriesFile::Open(Write(content), error));
+        return error;
+    }
+
+    std::vector<std::string> paths_;
+};
+
+// Binary file with columns time, a, b and |rows| of (t, a, b)
+std::string Binary(const std::vector<std::vector<double>>& rows) {
+    std::string out("FXTS", 4);
+    auto put = [&](const void* p, size_t n) { out.append(static_cast<const char*>(p), n); };
+    const uint32_t version = 1;
+    const uint32_t columns = 3;
+    const uint32_t reserved = 0;
+    const uint64_t count = rows.size();
+    put(&version, 4);
+    put(&columns, 4);
+    put(&reserved, 4);
+    put(&count, 8);
+    for (const char* name : {"time", "a", "b"}) {
+        const uint16_t length = static_cast<uint16_t>(std::strlen(name));
+        put(&length, 2);
+        put(name, length);
+    }
+    out.resize((out.size() + 7) & ~size_t{7}, '\0');
+    for (const auto& row : rows) {
+        put(row.data(), row.size() * sizeof(double));
+    }
+    return out;
+}
+
+}  // namespace
+
+TEST_F(TimeSeriesTest, ReadsCsvColumns) {
+    auto file = Open("# recorded\ntime, speed, \"rpm\"\n\n0.0, 10, 800\n# gap\n1.0, 20, 900\n2.5, 30, 1000\n");
+    ASSERT_TRUE(file);
+    EXPECT_EQ(file->column("speed"), 0u);
+    EXPECT_EQ(file->column("rpm"), 1u);
+    EXPECT_FALSE(file->column("time"));
+    EXPECT_EQ(file->start_time(), 0.0);
+    EXPECT_EQ(file->end_time(), 2.5);
+
+    TimeSeriesCursor rpm(file, 1);
+    EXPECT_EQ(rpm.sample(1.0, false), 900.0);
+}
+
+TEST_F(TimeSeriesTest, SamplesStepAndLinear) {
+    auto file = Open("time,v\n0,0\n1,10\n3,30\n");
+    ASSERT_TRUE(file);
+    TimeSeriesCursor step(file, 0);
+    EXPECT_EQ(step.sample(0.0, false), 0.0);
+    EXPECT_EQ(step.sample(0.9, false), 0.0);
+    EXPECT_EQ(step.sample(1.0, false), 10.0);
+    EXPECT_EQ(step.sample(2.9, false), 10.0);
+
+    TimeSeriesCursor linear(file, 0);
+    EXPECT_DOUBLE_EQ(linear.sample(0.5, true), 5.0);
+    EXPECT_DOUBLE_EQ(linear.sample(2.0, true), 20.0);
+    EXPECT_DOUBLE_EQ(linear.sample(3.0, true), 30.0);
+}
+
+TEST_F(TimeSeriesTest, HoldsEndsOutsideTheRecording) {
+    auto file = Open("time,v\n1,10\n2,20\n");
+    ASSERT_TRUE(file);
+    TimeSeriesCursor cursor(file, 0);
+    EXPECT_EQ(cursor.sample(-5.0, true), 10.0);
+    EXPECT_EQ(cursor.sample(0.5, true), 10.0);
+    EXPECT_EQ(cursor.sample(100.0, true), 20.0);
+    EXPECT_EQ(cursor.sample(1000.0, false), 20.0);
+
+    // Time only goes back after a rewind
+    cursor.rewind();
+    EXPECT_DOUBLE_EQ(cursor.sample(1.5, true), 15.0);
+}
+
+TEST_F(TimeSeriesTest, ReadsBinaryRows) {
+    auto file = Open(Binary({{0.0, 1.0, 100.0}, {2.0, 3.0, 300.0}}));
+    ASSERT_TRUE(file);
+    EXPECT_EQ(file->column("b"), 1u);
+    EXPECT_EQ(file->end_time(), 2.0);
+    TimeSeriesCursor b(file, 1);
+    EXPECT_DOUBLE_EQ(b.sample(1.0, true), 200.0);
+    EXPECT_EQ(b.sample(5.0, true), 300.0);
+}
+
+TEST_F(TimeSeriesTest, RejectsMalformedFiles) {
+    EXPECT_NE(OpenError("").find("empty"), std::string::npos);
+    EXPECT_NE(OpenError("time\n0\n").find("value column"), std::string::npos);
+    EXPECT_NE(OpenError("time,v\n").find("no readable data rows"), std::string::npos);
+    EXPECT_NE(OpenError("time,v\n2,0\n1,0\n").find("decreases"), std::string::npos);
+
+    std::string truncated = Binary({{0.0, 1.0, 2.0}, {1.0, 1.0, 2.0}});
+    truncated.resize(truncated.size() - 8);
+    EXPECT_NE(OpenError(truncated).find("shorter"), std::string::npos);
+
+    std::string error;
+    EXPECT_FALSE(TimeSeriesFile::Open("/tmp/no_such_time_series.csv", error));
+}
+
+TEST_F(TimeSeriesTest, SharesOpenFilesAndReleasesClosedOnes) {
+    const std::string path = Write("time,v\n0,1\n");
+    std::string error;
+    auto first = TimeSeriesFile::Open(path, error);
+    auto second = TimeSeriesFile::Open(path, error);
+    ASSERT_TRUE(first);
+    EXPECT_EQ(first, second);
+
+    // Once nothing uses it, the next Open() maps the file afresh
+    first.reset();
+    second.reset();
+    std::ofstream(path) << "time,v\n0,7\n";
+    auto reopened = TimeSeriesFile::Open(path, error);
+    ASSERT_TRUE(reopened) << error;
+    EXPECT_EQ(TimeSeriesCursor(reopened, 0).sample(0.0, false), 7.0);
+}
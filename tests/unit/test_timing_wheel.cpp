@@ -0,0 +1,91 @@
+/**
+ * @file test_timing_wheel.cpp
+ * @brief Unit tests for TimingWheel expiry and deadlines
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "timing_wheel.hpp"
+
+using namespace std::chrono_literals;
+using Clock = TimingWheel::Clock;
+
+namespace {
+
+const Clock::time_point kOrigin{};
+
+std::vector<uint32_t> Advance(TimingWheel& wheel, Clock::duration since_origin) {
+    std::vector<uint32_t> expired;
+    wheel.advance(kOrigin + since_origin, expired);
+    std::sort(expired.begin(), expired.end());
+    return expired;
+}
+
+}  // namespace
+
+TEST(TimingWheelTest, ExpiresOnceDeadlineIsReached) {
+    TimingWheel wheel(10ms, 8, kOrigin);
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_FALSE(wheel.next_deadline());
+
+    // Rounded up to the resolution
+    wheel.schedule(1, kOrigin + 25ms);
+    EXPECT_EQ(wheel.next_deadline(), kOrigin + 30ms);
+    EXPECT_TRUE(Advance(wheel, 29ms).empty());
+    EXPECT_EQ(Advance(wheel, 30ms), (std::vector<uint32_t>{1}));
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_FALSE(wheel.next_deadline());
+}
+
+TEST(TimingWheelTest, PastDeadlineExpiresOnNextTick) {
+    TimingWheel wheel(10ms, 8, kOrigin);
+    EXPECT_TRUE(Advance(wheel, 50ms).empty());
+    wheel.schedule(1, kOrigin + 20ms);
+    EXPECT_EQ(wheel.next_deadline(), kOrigin + 60ms);
+    EXPECT_EQ(Advance(wheel, 60ms), (std::vector<uint32_t>{1}));
+}
+
+TEST(TimingWheelTest, LaterTurnWaitsInItsSlot) {
+    TimingWheel wheel(10ms, 8, kOrigin);
+    wheel.schedule(1, kOrigin + 210ms);  // Tick 21: slot 5, third turn
+    wheel.schedule(2, kOrigin + 30ms);   // Tick 3, first turn
+    EXPECT_EQ(wheel.next_deadline(), kOrigin + 30ms);
+    EXPECT_EQ(Advance(wheel, 30ms), (std::vector<uint32_t>{2}));
+
+    // The next occupied slot holds a later turn's entry: the wheel reports
+    // each pass over it, an early wake that expires nothing
+    EXPECT_EQ(wheel.next_deadline(), kOrigin + 50ms);
+    EXPECT_TRUE(Advance(wheel, 50ms).empty());
+    EXPECT_EQ(wheel.next_deadline(), kOrigin + 130ms);
+    EXPECT_TRUE(Advance(wheel, 130ms).empty());
+
+    // Past the second wrap-around the slot comes up due
+    EXPECT_EQ(wheel.next_deadline(), kOrigin + 210ms);
+    EXPECT_TRUE(Advance(wheel, 200ms).empty());
+    EXPECT_EQ(Advance(wheel, 210ms), (std::vector<uint32_t>{1}));
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimingWheelTest, GapLongerThanATurnExpiresEverythingDue) {
+    TimingWheel wheel(10ms, 8, kOrigin);
+    wheel.schedule(1, kOrigin + 10ms);
+    wheel.schedule(2, kOrigin + 90ms);   // Same slot as 1, one turn later
+    wheel.schedule(3, kOrigin + 200ms);
+    wheel.schedule(4, kOrigin + 500ms);
+
+    EXPECT_EQ(Advance(wheel, 250ms), (std::vector<uint32_t>{1, 2, 3}));
+    EXPECT_FALSE(wheel.empty());
+    EXPECT_EQ(Advance(wheel, 500ms), (std::vector<uint32_t>{4}));
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimingWheelTest, AdvancingBackwardsDoesNothing) {
+    TimingWheel wheel(10ms, 8, kOrigin);
+    wheel.schedule(1, kOrigin + 100ms);
+    EXPECT_TRUE(Advance(wheel, 40ms).empty());
+    EXPECT_TRUE(Advance(wheel, 20ms).empty());
+    EXPECT_EQ(Advance(wheel, 100ms), (std::vector<uint32_t>{1}));
+}
@@ -0,0 +1,169 @@
+/**
+ * @file test_worker_pool.cpp
+ * @brief Unit tests for WorkerPool scheduling
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "worker_pool.hpp"
+
+using namespace std::chrono_literals;
+using Clock = WorkerPool::Clock;
+
+namespace {
+
+// Records when it is polled; |next| decides what each poll returns
+class RecordingTask : public WorkerPool::Task {
+public:
+    explicit RecordingTask(std::function<Clock::time_point(size_t)> next) : next_(std::move(next)) {}
+
+    Clock::time_point poll() override {
+        const size_t count = polls();
+        const auto due = next_(count);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            times_.push_back(Clock::now());
+        }
+        cv_.notify_all();
+        return due;
+    }
+
+    size_t polls() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return times_.size();
+    }
+
+    Clock::time_point poll_time(size_t index) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return times_.at(index);
+    }
+
+    bool wait_for_polls(size_t count, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cv_.wait_for(lock, timeout, [&] { return times_.size() >= count; });
+    }
+
+private:
+    std::function<Clock::time_point(size_t)> next_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Clock::time_point> times_;
+};
+
+Clock::time_point Never(size_t) {
+    return Clock::time_point::max();
+}
+
+}  // namespace
+
+TEST(WorkerPoolTest, PollsEveryTaskOnStart) {
+    RecordingTask first(Never);
+    RecordingTask second(Never);
+    WorkerPool pool(1);
+    pool.add(&first);
+    pool.add(&second);
+    pool.start();
+
+    EXPECT_TRUE(first.wait_for_polls(1, 1s));
+    EXPECT_TRUE(second.wait_for_polls(1, 1s));
+    pool.stop();
+}
+
+TEST(WorkerPoolTest, HonoursDueTime) {
+    RecordingTask task([](size_t count) { return count == 0 ? Clock::now() + 100ms : Clock::time_point::max(); });
+    WorkerPool pool(2);
+    pool.add(&task);
+    pool.start();
+
+    ASSERT_TRUE(task.wait_for_polls(2, 1s));
+    EXPECT_GE(task.poll_time(1) - task.poll_time(0), 100ms);
+    pool.stop();
+}
+
+TEST(WorkerPoolTest, WakeDuringPollPollsAgain) {
+    std::atomic<bool> in_poll{false};
+    std::atomic<bool> release{false};
+    RecordingTask task([&](size_t count) {
+        if (count == 0) {
+            in_poll = true;
+            while (!release) {
+                std::this_thread::sleep_for(1ms);
+            }
+        }
+        return Clock::time_point::max();
+    });
+    WorkerPool pool(1);
+    const size_t id = pool.add(&task);
+    pool.start();
+
+    while (!in_poll) {
+        std::this_thread::sleep_for(1ms);
+    }
+    pool.wake(id);
+    release = true;
+
+    // The first poll returned max(), so only the wake can bring the second
+    EXPECT_TRUE(task.wait_for_polls(2, 1s));
+    pool.stop();
+}
+
+TEST(WorkerPoolTest, WakeSupersedesScheduledPoll) {
+    RecordingTask task([](size_t count) { return count == 0 ? Clock::now() + 200ms : Clock::time_point::max(); });
+    WorkerPool pool(1);
+    const size_t id = pool.add(&task);
+    pool.start();
+    ASSERT_TRUE(task.wait_for_polls(1, 1s));
+    std::this_thread::sleep_for(50ms);  // Let the poll return and queue its 200ms entry
+
+    pool.wake(id);
+    ASSERT_TRUE(task.wait_for_polls(2, 100ms)) << "Wake did not poll the task right away";
+
+    // The entry due in 200ms belongs to an older generation and must not poll
+    EXPECT_FALSE(task.wait_for_polls(3, 400ms));
+    pool.stop();
+}
+
+TEST(WorkerPoolTest, StopWaitsForRunningPoll) {
+    std::atomic<bool> in_poll{false};
+    std::atomic<bool> finished{false};
+    RecordingTask task([&](size_t) {
+        in_poll = true;
+        std::this_thread::sleep_for(100ms);
+        finished = true;
+        return Clock::time_point::max();
+    });
+    WorkerPool pool(2);
+    pool.add(&task);
+    pool.start();
+
+    while (!in_poll) {
+        std::this_thread::sleep_for(1ms);
+    }
+    pool.stop();
+    EXPECT_TRUE(finished);
+    EXPECT_EQ(task.polls(), 1u);
+
+    // Stopping again, and waking a stopped pool, do nothing
+    pool.wake(0);
+    pool.stop();
+    EXPECT_EQ(task.polls(), 1u);
+}
+
+TEST(WorkerPoolTest, StopReturnsWhileIdle) {
+    RecordingTask task(Never);
+    WorkerPool pool(4);
+    pool.add(&task);
+    pool.start();
+    ASSERT_TRUE(task.wait_for_polls(1, 1s));
+
+    const auto before = Clock::now();
+    pool.stop();
+    EXPECT_LT(Clock::now() - before, 500ms);
+}